@@ -1,30 +1,198 @@
 #include "Inventory.h"
+#include "InventoryReplicationComponent.h"
+#include "InventoryGridWidget.h"
+#include "Math/VectorRegister.h"
+#include "TimerManager.h"
+#include "Engine/AssetManager.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Sort.h"
+#include "Algo/StableSort.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+DEFINE_LOG_CATEGORY(LogInventory);
+
+#if INVENTORY_STATS_ENABLED
+DEFINE_STAT(STAT_InventoryAddItem);
+DEFINE_STAT(STAT_InventoryRefresh);
+DEFINE_STAT(STAT_InventoryCreateItemIcon);
+DEFINE_STAT(STAT_InventoryFindHoveredSlot);
+DEFINE_STAT(STAT_InventoryRearrange);
+DEFINE_STAT(STAT_InventoryDropSpawn);
+DEFINE_STAT(STAT_InventoryGridPaint);
+DEFINE_STAT(STAT_InventoryGridDrawElements);
+DEFINE_STAT(STAT_InventorySlotsRebuilt);
+DEFINE_STAT(STAT_InventoryWidgetsCreated);
+DEFINE_STAT(STAT_InventorySyncAssetLoads);
+DEFINE_STAT(STAT_InventoryActorsSpawned);
+DEFINE_STAT(STAT_InventoryActorsDestroyed);
+
+UE_TRACE_CHANNEL_DEFINE(InventoryChannel);
+#endif
+
+namespace
+{
+    // Slot size box dimensions and the grid padding around every slot
+    constexpr float InventorySlotSize = 100.0f;
+    constexpr float InventorySlotPadding = 7.0f;
+
+    // Distance between two neighbouring slot rows (or columns)
+    constexpr float InventorySlotPitch = InventorySlotSize + 2.0f * InventorySlotPadding;
+
+    // Dragging closer than this to the top or bottom of the grid auto-scrolls it
+    constexpr float InventoryAutoScrollEdge = 40.0f;
+
+    // Cursor has to travel this far from where it got pressed before an item gets dragged
+    constexpr float InventoryDragThreshold = 4.0f;
+
+    // Sorting key extraction and sorting go parallel from this many slots on, in chunks of this size
+    constexpr int32 InventoryParallelSortMinSlots = 4096;
+    constexpr int32 InventorySortChunkSize = 1024;
+
+    // Sort key of one slot: archetype rank in the high half, item index in the low half, empty slots last
+    struct FInventorySortKey
+    {
+        uint64 Key = MAX_uint64;
+        int32 SlotIndex = INDEX_NONE;
+
+        bool operator<(const FInventorySortKey& Other) const
+        {
+            return Key != Other.Key ? Key < Other.Key : SlotIndex < Other.SlotIndex;
+        }
+    };
+
+    // Sorts chunks in parallel then merges them pairwise, level by level (every level's merges run in parallel too)
+    void ParallelSortKeys(TArray<FInventorySortKey>& Keys)
+    {
+        const int32 NumKeys = Keys.Num();
+        const int32 NumChunks = FMath::DivideAndRoundUp(NumKeys, InventorySortChunkSize);
+
+        ParallelFor(NumChunks, [&Keys, NumKeys](int32 ChunkIndex)
+        {
+            const int32 Begin = ChunkIndex * InventorySortChunkSize;
+            Algo::Sort(TArrayView<FInventorySortKey>(Keys.GetData() + Begin, FMath::Min(InventorySortChunkSize, NumKeys - Begin)));
+        });
+
+        TArray<FInventorySortKey> Merged;
+        Merged.SetNumUninitialized(NumKeys);
+
+        for (int32 Width = InventorySortChunkSize; Width < NumKeys; Width *= 2)
+        {
+            const int32 NumMerges = FMath::DivideAndRoundUp(NumKeys, 2 * Width);
+            ParallelFor(NumMerges, [&Keys, &Merged, NumKeys, Width](int32 MergeIndex)
+            {
+                const int32 Begin = MergeIndex * 2 * Width;
+                const int32 Middle = FMath::Min(Begin + Width, NumKeys);
+                const int32 End = FMath::Min(Begin + 2 * Width, NumKeys);
+
+                int32 Left = Begin;
+                int32 Right = Middle;
+                for (int32 Out = Begin; Out < End; ++Out)
+                {
+                    // Left run wins ties, so the merge is stable
+                    const bool bTakeLeft = Right >= End || (Left < Middle && !(Keys[Right] < Keys[Left]));
+                    Merged[Out] = bTakeLeft ? Keys[Left++] : Keys[Right++];
+                }
+            });
+
+            Swap(Keys, Merged);
+        }
+    }
+
+    // Every constructed inventory widget, cross-inventory drops look for their target in here
+    TArray<TWeakObjectPtr<UInventory>>& GetLiveInventories()
+    {
+        static TArray<TWeakObjectPtr<UInventory>> LiveInventories;
+        return LiveInventories;
+    }
+
+    // Whether an archetype's mesh and every material are already in memory
+    bool AreArchetypeAssetsResident(const FInventoryArchetype& Archetype)
+    {
+        if (!Archetype.StaticMesh.IsNull() && !Archetype.StaticMesh.Get())
+            return false;
+
+        for (const TSoftObjectPtr<UMaterialInterface>& Material : Archetype.StoredMaterials)
+        {
+            if (!Material.IsNull() && !Material.Get())
+                return false;
+        }
+
+        return true;
+    }
+
+    // Slot label: the item index, followed by the quantity for stacks
+    FText MakeItemLabel(int32 ItemId, int32 Quantity)
+    {
+        if (Quantity > 1)
+            return FText::Format(INVTEXT("{0} x{1}"), FText::AsNumber(ItemId), FText::AsNumber(Quantity));
+
+        return FText::AsNumber(ItemId);
+    }
+}
 
 UInventory::UInventory(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer),
+      ActorPoolBudget(32),
       MaxRows(3),
       MaxColumns(4),
+      VisibleRows(3),
+      OverscanRows(1),
+      AutoScrollSpeed(600.0f),
+      MaxStackSize(20),
+      bUseLeafGridRenderer(false),
+      NumWidgetRows(0),
+      ScrollOffset(0.0f),
+      FirstVisibleRow(0),
+      bIsItemsViewStale(true),
+      LastRefreshRebuiltSlotCount(0),
+      SlotRectGridPosition(FVector2D::ZeroVector),
+      SlotRectGridSize(FVector2D::ZeroVector),
+      bIsSlotRectTableValid(false),
+      bAreSlotRectsUniform(false),
+      SlotLatticeOrigin(FVector2D::ZeroVector),
+      SlotLatticePitch(FVector2D::ZeroVector),
+      SlotLatticeSize(FVector2D::ZeroVector),
+      WidgetAllocationCount(0),
+      TrackedAllocationCount(0),
+      DragStartAllocationCount(0),
+      LastDragAllocationCount(0),
       Canvas(nullptr),
       Background(nullptr),
+      BackgroundInvalidationBox(nullptr),
       BackgroundSlot(nullptr),
       BackgroundVerticalBox(nullptr),
       Title(nullptr),
       TitleVerticalBoxSlot(nullptr),
+      GridViewport(nullptr),
+      GridScrollBox(nullptr),
       Grid(nullptr),
       GridVerticalBoxSlot(nullptr),
       GridSlot(nullptr),
-      PoppedOutItemWidget(nullptr),
+      LeafGrid(nullptr),
       HoveredSlotIndex(INDEX_NONE),
       OriginSlotIndex(INDEX_NONE),
-      PoppedOutItem(FItem()),
+      BlockedLoadSeconds(0.0),
+      LastSnapshotLoadSeconds(0.0),
+      LastSortMoveCount(0),
       MouseScreenSpacePosition(FVector2D::ZeroVector),
       MouseWidgetLocalPosition(FVector2D::ZeroVector),
+      PressScreenSpacePosition(FVector2D::ZeroVector),
+      bSplitOnDragStart(false),
+      PendingMouseMoveEvents(0),
+      LastFrameMouseMoveEvents(0),
+      TotalMouseMoveEvents(0),
+      TotalDragUpdates(0),
+      LastFlushCommandCount(0),
       DragState(EDragState::None),
       bIsMouseInsideInventory(false)
 {
     // Set menber array's size to 12 (3x4)
-    Items.SetNum(MaxRows * MaxColumns);
+    ResetSlots(MaxRows * MaxColumns);
     Slots.SetNum(MaxRows * MaxColumns);
+    ItemIdAllocator.Reset(MaxRows * MaxColumns);
 }
 
 void UInventory::NativeOnInitialized()
@@ -33,12 +201,14 @@ void UInventory::NativeOnInitialized()
 
     Super::NativeOnInitialized();
 
+    ActorPool.SetBudget(ActorPoolBudget);
+
     if (!WidgetTree)
     {
         #if WITH_EDITOR
-             UE_LOG(LogTemp, Error, TEXT("WidgetTree is null"));
+             UE_LOG(LogInventory, Error, TEXT("WidgetTree is null"));
         #else
-             UE_LOG(LogTemp, Fatal, TEXT("WidgetTree is null"));
+             UE_LOG(LogInventory, Fatal, TEXT("WidgetTree is null"));
         #endif
 
         return;
@@ -67,18 +237,55 @@ void UInventory::NativeOnInitialized()
 
     // Create a grid for the inevntory and readjust grid alignment within baackground's vertical box 
     Grid = NewObject<UUniformGridPanel>(this);
-    Grid->SetSlotPadding(FMargin(7.0f, 7.0f, 7.0f, 7.0f));
-    GridVerticalBoxSlot = BackgroundVerticalBox->AddChildToVerticalBox(Grid);
+    Grid->SetSlotPadding(FMargin(InventorySlotPadding));
+
+    // Grid scrolls inside a clipped viewport, the scroll box only ever moves it by less than a row
+    // (mouse wheel and scrollbar are driven by the inventory itself, see SetScrollOffset())
+    GridScrollBox = NewObject<UScrollBox>(this);
+    GridScrollBox->SetScrollBarVisibility(ESlateVisibility::Collapsed);
+    GridScrollBox->SetConsumeMouseWheel(EConsumeMouseWheel::Never);
+    GridScrollBox->SetAllowOverscroll(false);
+
+    // Leaf renderer mode paints every slot from one widget, the uniform grid then stays out of the tree
+    if (bUseLeafGridRenderer)
+    {
+        LeafGrid = NewTrackedWidget<UInventoryGridWidget>();
+        GridScrollBox->AddChild(LeafGrid);
+    }
+    else
+    {
+        GridScrollBox->AddChild(Grid);
+    }
+
+    GridViewport = NewObject<USizeBox>(this);
+    GridViewport->SetClipping(EWidgetClipping::ClipToBounds);
+    GridViewport->SetContent(GridScrollBox);
+
+    GridVerticalBoxSlot = BackgroundVerticalBox->AddChildToVerticalBox(GridViewport);
     GridVerticalBoxSlot->SetHorizontalAlignment(HAlign_Fill);
     GridVerticalBoxSlot->SetVerticalAlignment(VAlign_Fill);
 
     // Setting BackgourndBorder content to what is inside the BackgroundBorder's VerticalBox and position/anchoring
     Background->SetContent(BackgroundVerticalBox);
-    BackgroundSlot = Canvas->AddChildToCanvas(Background);
+
+    // Whole inventory body sits in an invalidation box, only widgets that actually changed get laid out and painted again
+    // (the drag ghost stays outside of it, moving it must not invalidate the cached body)
+    BackgroundInvalidationBox = NewObject<UInvalidationBox>(this);
+    BackgroundInvalidationBox->SetCanCache(true);
+    BackgroundInvalidationBox->SetContent(Background);
+
+    BackgroundSlot = Canvas->AddChildToCanvas(BackgroundInvalidationBox);
     BackgroundSlot->SetAnchors(FAnchors(1.0f, 0.0f, 1.0f, 0.0f));
     BackgroundSlot->SetAlignment(FVector2D(1.0f, 0.0f));
     BackgroundSlot->SetOffsets(FMargin(-10.0f, 11.0f, 485.0f, 419.0f));
 
+    // Drag ghost lives as long as the inventory
+    BuildGhostWidget();
+
+    // Commands drain from the core ticker, NativeTick() stops running as soon as the inventory is collapsed
+    if (!CommandFlushTickerHandle.IsValid())
+        CommandFlushTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UInventory::TickCommandQueue));
+
     // Call create method to colonize the inventory with slots
     Create();
 }
@@ -87,10 +294,35 @@ void UInventory::NativeConstruct()
 {
     Super::NativeConstruct();
 
-    // Refresh inventory before it gets added to viewport
+    GetLiveInventories().AddUnique(this);
+
+    // Refresh every slot before the inventory gets added to viewport
+    MarkAllSlotsDirty();
     RefreshInventory();
 }
 
+void UInventory::NativeDestruct()
+{
+    // Don't leave hidden picked up actors behind if the batch never got to run
+    DestroyPendingActors();
+    ActorPool.Empty();
+
+    GetLiveInventories().RemoveAllSwap([this](const TWeakObjectPtr<UInventory>& Inventory) { return !Inventory.IsValid() || Inventory.Get() == this; });
+
+    Super::NativeDestruct();
+}
+
+void UInventory::BeginDestroy()
+{
+    if (CommandFlushTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(CommandFlushTickerHandle);
+        CommandFlushTickerHandle.Reset();
+    }
+
+    Super::BeginDestroy();
+}
+
 FReply UInventory::NativeOnMouseButtonDown(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
 {
     if (InMouseEvent.IsMouseButtonDown(EKeys::LeftMouseButton))
@@ -98,29 +330,38 @@ FReply UInventory::NativeOnMouseButtonDown(const FGeometry& InGeometry, const FP
         HoveredSlotIndex = FindHoveredSlot(InMouseEvent);
 
         // Checking whether hovered slot index is not invalid and it exist as a valid index for the items array 
-        if (HoveredSlotIndex != INDEX_NONE && Items.IsValidIndex(HoveredSlotIndex))
+        if (IsValidSlot(HoveredSlotIndex))
         {
-            // Then checking for item validity by checking whether it's object reference as been initialized 
-            // (Which should be already intialized) 
-            if (Items[HoveredSlotIndex].WorldObjectReference)
+            // Then checking for item validity by checking whether the slot holds an archetype
+            if (IsSlotOccupied(HoveredSlotIndex))
             {
+                // Shift pressing a stack splits half of it off once the press turns into a drag (a Shift click alone splits nothing)
+                bSplitOnDragStart = InMouseEvent.IsShiftDown() && !IsReplicatedClient();
+
                 // Keeping track of original slot before drag
                 OriginSlotIndex = HoveredSlotIndex;
 
                 // Setting the item on the hoivered slot as the drag item
-                PoppedOutItem = Items[HoveredSlotIndex];
+                PoppedOutItem = ReadSlot(HoveredSlotIndex);
 
                 DragState = EDragState::Pressed; 
+                TraceEvent(EInventoryTraceEventType::DragPressed, OriginSlotIndex, INDEX_NONE, PoppedOutItem.ItemId);
+
+                // Start counting allocations for this drag
+                DragStartAllocationCount = TrackedAllocationCount;
+
+                // Drag threshold is measured from here
+                PressScreenSpacePosition = InMouseEvent.GetScreenSpacePosition();
+                MouseScreenSpacePosition = PressScreenSpacePosition;
+
+                // Item may get dropped to the world, get its assets streaming before that happens
+                PrefetchPoppedOutItemAssets();
 
                 // Retriving the low-level slate widget representation of this inevntory
                 TSharedPtr<SWidget> RootSlate = GetCachedWidget();
                 if (!RootSlate.IsValid())
                 {
-                    #if	WITH_EDITOR
-                        UE_LOG(LogTemp, Error, TEXT("Couldn't get cached root slate widget!"));
-                    #else
-                        UE_LOG(LogTemp, Fatal, TEXT("Couldn't get cached root slate widget!"));
-                    #endif
+                    UE_LOG(LogInventory, Error, TEXT("Couldn't get cached root slate widget!"));
 
                     return FReply::Unhandled();
                 }
@@ -141,102 +382,10 @@ FReply UInventory::NativeOnMouseMove(const FGeometry& InGeometry, const FPointer
 
     Super::NativeOnMouseMove(InGeometry, InMouseEvent);
 
+    // Only the latest cursor is kept, NativeTick() processes it once per frame however many events arrive
     MouseScreenSpacePosition = InMouseEvent.GetScreenSpacePosition();
-    MouseWidgetLocalPosition = InGeometry.AbsoluteToLocal(MouseScreenSpacePosition);
-
-    // Updating whether the mouse is inside the inventory background
-    bIsMouseInsideInventory = false;
-    if (Background && Background->IsValidLowLevelFast())
-    {
-        const FGeometry& BackgroundGeom = Background->GetCachedGeometry();
-        bIsMouseInsideInventory = BackgroundGeom.IsUnderLocation(MouseScreenSpacePosition);
-    }
-
-    // Checking for starting a drag (with movement threshold instead of requiring exit)
-    if (DragState == EDragState::Pressed && OriginSlotIndex != INDEX_NONE && Slots.IsValidIndex(OriginSlotIndex))
-    {
-        const FVector2D& DeltaCursor = InMouseEvent.GetCursorDelta();
-        if (DeltaCursor.SizeSquared() > FMath::Square(4.0f)) // drag threshold
-        {
-            // Transitioning to dragging
-            UBorder* OriginBorder = Slots[OriginSlotIndex].Get();
-            if (OriginBorder && OriginBorder->IsValidLowLevelFast())
-            {
-                if (USizeBox* Box = Cast<USizeBox>(OriginBorder->GetContent()))
-                    Box->ClearChildren();
-
-                DragState = EDragState::Dragging;
-
-                PoppedOutItemWidget = NewObject<UOverlay>(this);
-                if (!PoppedOutItemWidget)
-                {
-                    UE_LOG(LogTemp, Error, TEXT("Failed to create PoppedOutItemWidget"));
-                    return FReply::Handled();
-                }
-
-                PoppedOutItemWidget->SetVisibility(ESlateVisibility::HitTestInvisible);
-
-                UImage* Image = NewObject<UImage>(this);
-                Image->SetVisibility(ESlateVisibility::Visible);
-                Image->SetColorAndOpacity(FLinearColor::Blue);
-                if (UOverlaySlot* ImageSlot = PoppedOutItemWidget->AddChildToOverlay(Image))
-                {
-                    ImageSlot->SetHorizontalAlignment(HAlign_Fill);
-                    ImageSlot->SetVerticalAlignment(VAlign_Fill);
-                }
-
-                UTextBlock* Text = NewObject<UTextBlock>(this);
-                Text->SetVisibility(ESlateVisibility::Visible);
-                Text->SetText(FText::AsNumber(PoppedOutItem.Index));
-                Text->SetColorAndOpacity(FLinearColor::Red);
-                Text->SetJustification(ETextJustify::Center);
-                Text->SetFont(FCoreStyle::GetDefaultFontStyle(TEXT("Regular"), 20));
-                if (UOverlaySlot* TextSlot = PoppedOutItemWidget->AddChildToOverlay(Text))
-                {
-                    TextSlot->SetHorizontalAlignment(HAlign_Center);
-                    TextSlot->SetVerticalAlignment(VAlign_Center);
-                }
-
-                if (Canvas && Canvas->IsValidLowLevelFast())
-                {
-                    if (UCanvasPanelSlot* CanvasSlot = Canvas->AddChildToCanvas(PoppedOutItemWidget))
-                    {
-                        CanvasSlot->SetSize(FVector2D(100.0f, 100.0f));
-                        CanvasSlot->SetPosition(MouseWidgetLocalPosition - FVector2D(50.0f, 50.0f));
-                        CanvasSlot->SetZOrder(100);
-                    }
-                    else
-                    {
-                        UE_LOG(LogTemp, Error, TEXT("Failed to add popped-out widget to canvas"));
-                    }
-                }
-            }
-        }
-    }
-
-    // Handling dragging behavior
-    if (DragState == EDragState::Dragging && PoppedOutItemWidget)
-    {
-        // Moving smooth the dragged widget
-        if (UCanvasPanelSlot* DraggedItemWidgetSlot = Cast<UCanvasPanelSlot>(PoppedOutItemWidget->Slot))
-        {
-            FVector2D TargetPosition = MouseWidgetLocalPosition - FVector2D(50.0f, 50.0f);
-            FVector2D CurrentPosition = DraggedItemWidgetSlot->GetPosition();
-            FVector2D NewPosition = FMath::Vector2DInterpTo(CurrentPosition, TargetPosition, GetWorld()->DeltaTimeSeconds, 25.0f);
-            DraggedItemWidgetSlot->SetPosition(NewPosition);
-        }
-
-        // Updating hovered slot
-        HoveredSlotIndex = FindHoveredSlot(InMouseEvent);
-
-        // Rearranging internally items while dragging
-        if (bIsMouseInsideInventory && HoveredSlotIndex != INDEX_NONE)
-        {
-            InternallyRearrangeItems(InMouseEvent);
-        }
-
-        return FReply::Handled();
-    }
+    ++PendingMouseMoveEvents;
+    ++TotalMouseMoveEvents;
 
     return FReply::Handled();
 }
@@ -247,326 +396,1709 @@ FReply UInventory::NativeOnMouseButtonUp(const FGeometry& InGeometry, const FPoi
     if (DragState != EDragState::Pressed && DragState != EDragState::Dragging)
         return Super::NativeOnMouseButtonUp(InGeometry, InMouseEvent);
 
-    // Remove popped out item widget from canvas if it exists
-    if (PoppedOutItemWidget)
-    {
-        Canvas->RemoveChild(PoppedOutItemWidget);
-        PoppedOutItemWidget = nullptr;
-    }
+    // Released before the drag started, a pending split never happens
+    bSplitOnDragStart = false;
+
+    // Hidden rather than collapsed or removed, so hiding the ghost doesn't touch the canvas layout
+    if (PoppedOutItemWidget.Overlay)
+        PoppedOutItemWidget.Overlay->SetVisibility(ESlateVisibility::Hidden);
 
     MouseScreenSpacePosition = InMouseEvent.GetScreenSpacePosition();
     HoveredSlotIndex = FindHoveredSlot(InMouseEvent);
 
-    // When hovered slot is valid and also exists in items array
-    if (HoveredSlotIndex != INDEX_NONE && Items.IsValidIndex(HoveredSlotIndex))
+    // The last mouse move may not have been processed by a tick yet
+    UpdateMouseInsideInventory();
+
+    // The dragged item still sits in the origin slot (interior rearranging keeps it there while dragging)
+    // so every drop on a slot is a swap: with an empty slot, with an occupied one or with itself
+    // Dropping onto a stack of the same item merges into it instead, whatever doesn't fit stays in the origin slot
+    if (IsReplicatedClient())
     {
-        // Release item on empty slot  
-        if (!Items[HoveredSlotIndex].WorldObjectReference)
-        {
-            Items[HoveredSlotIndex] = PoppedOutItem;
-            Items[OriginSlotIndex] = FItem{};
-        }
-        // Release item on the same slot  
-        else if (HoveredSlotIndex == OriginSlotIndex)
+        // Clients don't touch their slots, the server applies the move and replicates the outcome
+        // (drops to the world or another inventory have no server path here, they're ignored)
+        if (IsValidSlot(HoveredSlotIndex) && IsValidSlot(OriginSlotIndex) && HoveredSlotIndex != OriginSlotIndex)
+            ReplicationComponent->ServerMoveSlot(OriginSlotIndex, HoveredSlotIndex);
+    }
+    else if (IsValidSlot(HoveredSlotIndex))
+    {
+        if (IsValidSlot(OriginSlotIndex) && HoveredSlotIndex != OriginSlotIndex)
         {
-            Items[OriginSlotIndex] = PoppedOutItem;
+            if (CanMergeStacks(OriginSlotIndex, HoveredSlotIndex))
+            {
+                TraceEvent(EInventoryTraceEventType::Merged, OriginSlotIndex, HoveredSlotIndex, PoppedOutItem.ItemId);
+                MergeStacks(OriginSlotIndex, HoveredSlotIndex);
+            }
+            else
+            {
+                TraceEvent(EInventoryTraceEventType::Swapped, OriginSlotIndex, HoveredSlotIndex, PoppedOutItem.ItemId);
+                SwapSlots(OriginSlotIndex, HoveredSlotIndex);
+            }
         }
-        else
+    }
+    else if (UInventory* TargetInventory = !bIsMouseInsideInventory ? FindInventoryAt(MouseScreenSpacePosition) : nullptr)
+    {
+        // Released over another open inventory, the item moves there (onto the slot under the mouse or auto-placed)
+        if (IsValidSlot(OriginSlotIndex))
         {
-            // Swap with occupied slot  
-            Items[OriginSlotIndex] = Items[HoveredSlotIndex];
-            Items[HoveredSlotIndex] = PoppedOutItem;
+            TArray<int32> ArchetypeRemap;
+            MoveSlotBetween(*this, OriginSlotIndex, *TargetInventory, TargetInventory->FindHoveredSlotAt(MouseScreenSpacePosition), ArchetypeRemap);
+            TargetInventory->RefreshInventory();
         }
     }
     else if (!bIsMouseInsideInventory)
     {
         // Spawn world object when dropped outside inventory, using deferred spawn
-        if (UWorld* World = GetWorld(); World && OriginSlotIndex != INDEX_NONE && Items.IsValidIndex(OriginSlotIndex))
+        if (UWorld* World = GetWorld(); World && IsValidSlot(OriginSlotIndex))
         {
-            // Begin deferred spawn
-            FTransform SpawnTransform = PoppedOutItem.WorldObjectTransform;
-            AStaticMeshActor* MeshActor = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
-
-            if (MeshActor)
-            {
-                UStaticMeshComponent* MeshComp = MeshActor->GetStaticMeshComponent();
-                MeshComp->SetMobility(EComponentMobility::Movable);
-
-                // Set mesh
-                if (UStaticMesh* Mesh = PoppedOutItem.StaticMesh.LoadSynchronous())
-                {
-                    MeshComp->SetStaticMesh(Mesh);
-                }
-
-                // Apply stored materials safely
-                const int32 SlotCount = MeshComp->GetNumMaterials();
-                for (int32 MaterialIndex = 0; MaterialIndex < PoppedOutItem.StoredMaterials.Num(); ++MaterialIndex)
-                {
-                    // Validate slot index and load soft pointer
-                    if (MaterialIndex < SlotCount)
-                    {
-                        UMaterialInterface* Mat = PoppedOutItem.StoredMaterials[MaterialIndex].LoadSynchronous();
-                        if (Mat)
-                        {
-                            MeshComp->SetMaterial(MaterialIndex, Mat);
-                        }
-                    }
-                }
+            TraceEvent(EInventoryTraceEventType::DroppedToWorld, OriginSlotIndex, INDEX_NONE, PoppedOutItem.ItemId);
+            SpawnPoppedOutItem(World);
 
-                // Finish spawning so BP construction scripts run AFTER our setup
-                UGameplayStatics::FinishSpawningActor(MeshActor, SpawnTransform);
-            }
-
-            // Clear the original slot
-            Items[OriginSlotIndex] = FItem{};
+            // Clear the original slot, the whole stack left the inventory so its index is free again
+            ReleaseItemId(PoppedOutItem.ItemId);
+            ClearSlot(OriginSlotIndex);
         }
     }
-    else
-    {
-        // If dropped anywhere else inside inventory but not on a slot → restore
-        if (OriginSlotIndex != INDEX_NONE && Items.IsValidIndex(OriginSlotIndex))
-            Items[OriginSlotIndex] = PoppedOutItem;
-    }
 
-    // Reset state
-    PoppedOutItem = FItem{};
-    OriginSlotIndex = INDEX_NONE;
+    // If dropped anywhere else inside inventory but not on a slot the item simply stays in its origin slot
+    // Origin slot gets its icon back (or cleared) whatever the outcome of the drop
+    MarkSlotDirty(OriginSlotIndex);
+
+    // Reset state (releasing the prefetch, a placeholder spawn keeps its own reference)
+    PoppedOutItemAssetsHandle.Reset();
     DragState = EDragState::Dropped;
+    TraceEvent(EInventoryTraceEventType::Dropped, OriginSlotIndex, HoveredSlotIndex, PoppedOutItem.ItemId);
+
+    PoppedOutItem = FInventorySlotEntry();
+    OriginSlotIndex = INDEX_NONE;
     bIsMouseInsideInventory = false;
 
     RefreshInventory();
+
+    LastDragAllocationCount = TrackedAllocationCount - DragStartAllocationCount;
     return FReply::Handled().ReleaseMouseCapture();
 }
 
-void UInventory::AddItem(AActor* ItemActor)
+FReply UInventory::NativeOnMouseWheel(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
 {
-    if (!ItemActor) return;
-
-    int32 EmptySlot = FindFirstEmptySlot();
-    if (EmptySlot == INDEX_NONE)
-    {
-    
-        // When there's no empty slot inventory is full 
-        #if	WITH_EDITOR
-             UE_LOG(LogTemp, Error, TEXT("No free slots because inventory is full!"));
-        #endif
-
-        return;
-    }
-    
-    // Keep tarack of all existing indeces in the items array 
-    TSet<int32> UsedIndices;
-    for (const FItem& Item : Items)
-    {
-        if (Item.Index != INDEX_NONE)
-        {
-            UsedIndices.Add(Item.Index);
-        }
-    }
-
-    // Valid index is use for not duplicating indexes 
-    // giving always the next availble index that is not pressent on any inventory item
-    // (Remenber we do this by keeping track of the item array indexes with the set of used indices)
-    int32 ValidIndex = 0;
-    while (UsedIndices.Contains(ValidIndex)) // if 0,1,2 then continue
-    {
-        ++ValidIndex;
-    }
-
-    // Since empty slot is valid then assign this new element accordingly 
-    FItem& NewItem = Items[EmptySlot];
-
-    NewItem.WorldObjectReference = ItemActor->GetClass();
+    // Nothing to scroll when every row fits in view
+    if (MaxRows <= VisibleRows)
+        return Super::NativeOnMouseWheel(InGeometry, InMouseEvent);
 
-    NewItem.WorldObjectTransform = ItemActor->GetActorTransform();
-
-    // Assigning the next available valid index as a unique index for that item
-    NewItem.Index = ValidIndex;
+    // One row per wheel notch
+    SetScrollOffset(ScrollOffset - InMouseEvent.GetWheelDelta() * InventorySlotPitch);
+    return FReply::Handled();
+}
 
-    // Storing meshes and its multiple materials 
-    if (UStaticMeshComponent* MeshComponent = ItemActor->FindComponentByClass<UStaticMeshComponent>())
-    {
-        if (MeshComponent->GetStaticMesh())
-        {
-            NewItem.StaticMesh = TSoftObjectPtr<UStaticMesh>(MeshComponent->GetStaticMesh());
-        }
+void UInventory::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+    Super::NativeTick(MyGeometry, InDeltaTime);
 
-        for (int32 i = 0; i < MeshComponent->GetNumMaterials(); ++i)
-        {
-            UMaterialInterface* MaterialInterface = MeshComponent->GetMaterial(i);
-            if (IsValid(MaterialInterface))
-            {
-                NewItem.StoredMaterials.Add(TSoftObjectPtr<UMaterialInterface>(MaterialInterface));
-            }
-        }
-    }
+    const bool bHasMouseMoved = PendingMouseMoveEvents > 0;
+    LastFrameMouseMoveEvents = PendingMouseMoveEvents;
+    PendingMouseMoveEvents = 0;
 
-    RefreshInventory();
+    if (DragState != EDragState::Pressed && DragState != EDragState::Dragging)
+        return;
 
-    ItemActor->Destroy();
+    UpdateDrag(MyGeometry, InDeltaTime, bHasMouseMoved);
 }
 
-int32 UInventory::FindHoveredSlot(const FPointerEvent& InMouseEvent)
+void UInventory::UpdateDrag(const FGeometry& MyGeometry, float DeltaTime, bool bHasMouseMoved)
 {
-    MouseScreenSpacePosition = InMouseEvent.GetScreenSpacePosition();
+    bool bShouldResolveHover = false;
 
-    int32 NearestSlotIndex = INDEX_NONE;
+    if (bHasMouseMoved)
+    {
+        ++TotalDragUpdates;
+        bShouldResolveHover = true;
 
-    float MinimumDistanceToSlot = FLT_MAX;
+        MouseWidgetLocalPosition = MyGeometry.AbsoluteToLocal(MouseScreenSpacePosition);
+        UpdateMouseInsideInventory();
 
-    for (int32 Row = 0; Row < int32(MaxRows); ++Row)
-    {
-        for (int32 Column = 0; Column < int32(MaxColumns); ++Column)
+        // Checking for starting a drag (with movement threshold instead of requiring exit)
+        const bool bIsPastDragThreshold = FVector2D::DistSquared(MouseScreenSpacePosition, PressScreenSpacePosition) > FMath::Square(InventoryDragThreshold);
+        if (DragState == EDragState::Pressed && IsValidSlot(OriginSlotIndex) && bIsPastDragThreshold)
         {
-            // Keep thatc of current hovered slot for debugging purpuses
-            const int32 CurrentHoveredSlot = Row * MaxColumns + Column;
-
-            // Cheking whether current hovered slot is a vvalid slot index and it exist as an index on the slot array 
-            if (!Slots.IsValidIndex(CurrentHoveredSlot) || !Slots[CurrentHoveredSlot])
+            // Shift press: half of the stack goes into an empty slot and that half is what gets dragged
+            if (bSplitOnDragStart)
             {
-                #if	WITH_EDITOR
-                     UE_LOG(LogTemp, Error, TEXT("Hovered slot index %d is invalid on FindHoveredSlot()"), CurrentHoveredSlot);
-                #else
-                     UE_LOG(LogTemp, Error, TEXT("Hovered slot index %d is invalid on FindHoveredSlot()"), CurrentHoveredSlot);
-                #endif
+                bSplitOnDragStart = false;
 
-                continue;
+                const int32 SplitSlotIndex = SplitStack(OriginSlotIndex);
+                if (SplitSlotIndex != INDEX_NONE)
+                {
+                    TraceEvent(EInventoryTraceEventType::Split, OriginSlotIndex, SplitSlotIndex, SlotItemIds[SplitSlotIndex]);
+                    OriginSlotIndex = SplitSlotIndex;
+                    PoppedOutItem = ReadSlot(SplitSlotIndex);
+                    RefreshInventory();
+                }
             }
 
-            // Trsack slot geometry in order to check whther mouse is within slot bounds
-            const FGeometry SlotGeometry = Slots[CurrentHoveredSlot]->GetCachedGeometry();
-            const FVector2D SlotAbsoluteTopLeft = SlotGeometry.LocalToAbsolute(FVector2D::ZeroVector);
-            const FVector2D SlotAbsoluteSize = SlotGeometry.GetLocalSize();
-            const FVector2D SlotAbsoluteBottomRight = SlotAbsoluteTopLeft + SlotAbsoluteSize;
-
-            // Check whether the mouse position is anywhere inside mouse bounds 
-            if (MouseScreenSpacePosition.X >= SlotAbsoluteTopLeft.X && MouseScreenSpacePosition.X <= SlotAbsoluteBottomRight.X &&
-                MouseScreenSpacePosition.Y >= SlotAbsoluteTopLeft.Y && MouseScreenSpacePosition.Y <= SlotAbsoluteBottomRight.Y)
+            // Transitioning to dragging
+            const int32 OriginWidgetSlot = ItemSlotToWidgetSlot(OriginSlotIndex);
+            const bool bHasOriginIcon = LeafGrid ? OriginWidgetSlot != INDEX_NONE : SlotIcons.IsValidIndex(OriginWidgetSlot) && SlotIcons[OriginWidgetSlot].Overlay;
+            if (bHasOriginIcon)
             {
-                const FVector2D& HalfSlotScale = SlotAbsoluteSize * 0.5f;
+                // Hide the origin icon, the ghost takes its place under the mouse
+                if (LeafGrid)
+                    LeafGrid->SetSlot(OriginWidgetSlot, false, FText::GetEmpty());
+                else
+                    SlotIcons[OriginWidgetSlot].Overlay->SetVisibility(ESlateVisibility::Hidden);
 
-                const FVector2D& SlotCenter = SlotAbsoluteTopLeft + HalfSlotScale;
-
-                const float Distance = FVector2D::Distance(MouseScreenSpacePosition, SlotCenter);
+                DragState = EDragState::Dragging;
+                TraceEvent(EInventoryTraceEventType::DragStarted, OriginSlotIndex, INDEX_NONE, PoppedOutItem.ItemId);
 
-                // When distance between mouse position and center slot is less than FLT_MAX
-                // then just return the current hover slot as the neares slot
-                if (Distance < MinimumDistanceToSlot)
+                if (!PoppedOutItemWidget.Overlay)
                 {
-                    NearestSlotIndex = CurrentHoveredSlot;
-
-                    #if	WITH_EDITOR
-                         UE_LOG(LogTemp, Log, TEXT("Hovered slot index %d has mouse hovering over at a distance of %f"), CurrentHoveredSlot, Distance);
-                    #endif
+                    UE_LOG(LogInventory, Error, TEXT("PoppedOutItemWidget was never built"));
+                    return;
                 }
+
+                // Persistent ghost only gets its text, translation and visibility changed, none of which needs a layout pass
+                SetLabelText(PoppedOutItemWidget.Text, GetItemLabel(PoppedOutItem.ItemId, PoppedOutItem.Quantity));
+                PoppedOutItemWidget.Overlay->SetRenderTranslation(MouseWidgetLocalPosition - FVector2D(50.0f, 50.0f));
+                PoppedOutItemWidget.Overlay->SetVisibility(ESlateVisibility::HitTestInvisible);
             }
         }
     }
 
-    return NearestSlotIndex;
-}
+    if (DragState != EDragState::Dragging || !PoppedOutItemWidget.Overlay)
+        return;
 
-void UInventory::RefreshInventory()
-{
-    // Forcing widget layout update
-    if (Grid)   Grid->ForceLayoutPrepass();
-    if (Canvas) Canvas->ForceLayoutPrepass();
+    // Moving smooth the dragged widget, every frame so it keeps catching up while the mouse rests
+    // Render translation only, the ghost's canvas slot never moves so the canvas never needs a new layout
+    {
+        const FVector2D TargetPosition = MouseWidgetLocalPosition - FVector2D(50.0f, 50.0f);
+        const FVector2D CurrentPosition = PoppedOutItemWidget.Overlay->GetRenderTransform().Translation;
+        if (!CurrentPosition.Equals(TargetPosition, 0.5f))
+            PoppedOutItemWidget.Overlay->SetRenderTranslation(FMath::Vector2DInterpTo(CurrentPosition, TargetPosition, DeltaTime, 25.0f));
+    }
+
+    // Mouse may not move while auto-scrolling, so the item under it has to be re-resolved then too
+    if (UpdateAutoScroll(DeltaTime))
+        bShouldResolveHover = true;
 
-    // iterate through every slot 
-    for (int32 SlotIndex = 0; SlotIndex < Items.Num(); ++SlotIndex)
+    if (!bShouldResolveHover)
+        return;
+
+    // Updating hovered slot and rearranging internally items while dragging
+    HoveredSlotIndex = FindHoveredSlotAt(MouseScreenSpacePosition);
+    if (bIsMouseInsideInventory && HoveredSlotIndex != INDEX_NONE)
     {
-        if (!Slots.IsValidIndex(SlotIndex))
-            continue;
+        InternallyRearrangeItems();
+    }
+}
 
-        // Get slot and its size 
-        UBorder* SlotBorder = Slots[SlotIndex].Get();
-        if (!SlotBorder) continue;
+bool UInventory::UpdateAutoScroll(float DeltaTime)
+{
+    if (MaxRows <= VisibleRows || !GridViewport)
+        return false;
 
-        USizeBox* SizeBox = Cast<USizeBox>(SlotBorder->GetContent());
-        if (!SizeBox) continue;
+    // Auto-scroll while the dragged item is held close to the top or bottom edge of the grid
+    const FGeometry& ViewportGeometry = GridViewport->GetCachedGeometry();
+    const FVector2D ViewportMousePosition = ViewportGeometry.AbsoluteToLocal(MouseScreenSpacePosition);
+    const FVector2D ViewportSize = ViewportGeometry.GetLocalSize();
 
-        // Clear slot
-        SizeBox->ClearChildren();
+    if (ViewportMousePosition.X < 0.0f || ViewportMousePosition.X > ViewportSize.X)
+        return false;
 
-        // Skip the original slot when it empty due item dragging to not recreate an item
-        // on the mouse and on on the grid
-        if (DragState == EDragState::Dragging && SlotIndex == OriginSlotIndex)
-            continue;
+    float ScrollDirection = 0.0f;
+    if (ViewportMousePosition.Y < InventoryAutoScrollEdge)
+        ScrollDirection = -1.0f;
+    else if (ViewportMousePosition.Y > ViewportSize.Y - InventoryAutoScrollEdge)
+        ScrollDirection = 1.0f;
 
-        // Recreate all items
-        const FItem& Item = Items[SlotIndex];
-        if (Item.WorldObjectReference)
-            CreateItemIcon(SlotIndex);
+    if (ScrollDirection == 0.0f)
+        return false;
 
-        SlotBorder->SetVisibility(ESlateVisibility::Visible);
+    SetScrollOffset(ScrollOffset + ScrollDirection * AutoScrollSpeed * DeltaTime);
+    return true;
+}
 
-        // Force slot border widget layout update
-        SlotBorder->ForceLayoutPrepass();
+void UInventory::UpdateMouseInsideInventory()
+{
+    // Updating whether the mouse is inside the inventory background
+    bIsMouseInsideInventory = false;
+    if (Background && Background->IsValidLowLevelFast())
+    {
+        const FGeometry& BackgroundGeom = Background->GetCachedGeometry();
+        bIsMouseInsideInventory = BackgroundGeom.IsUnderLocation(MouseScreenSpacePosition);
     }
 }
 
-void UInventory::InternallyRearrangeItems(const FPointerEvent& MouseEvent)
+void UInventory::PrefetchPoppedOutItemAssets()
 {
-    // Returning early if none of these 2 states are true
-    if (DragState != EDragState::Dragging && DragState != EDragState::Pressed)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("Item needs to selected and moving for executiong interior drag"));
+    if (!ArchetypeTable.IsValidHandle(PoppedOutItem.Archetype))
+        return;
 
-        #if	WITH_EDITOR
-            UE_LOG(LogTemp, Error, TEXT("Item needs to selected and moving for executiong interior drag"));
-        #else
-            UE_LOG(LogTemp, Fatal, TEXT("Item needs to selected and moving for executiong interior drag"));
-        #endif
-        
+    const FInventoryArchetype& Archetype = ArchetypeTable.Get(PoppedOutItem.Archetype);
+
+    // Assets of an item that was picked up a moment ago are normally still resident, nothing to request then
+    if (AreArchetypeAssetsResident(Archetype))
         return;
-    }
 
-    // Update hovere slot 
-    HoveredSlotIndex = FindHoveredSlot(MouseEvent);
+    TArray<FSoftObjectPath> AssetPaths;
+    AssetPaths.Reserve(Archetype.StoredMaterials.Num() + 1);
 
-    // Checking whether hovered slot index is invalid and it doesn't exist as a valid index for the items array 
-    if (HoveredSlotIndex == INDEX_NONE || !Items.IsValidIndex(HoveredSlotIndex))
+    if (!Archetype.StaticMesh.IsNull())
+        AssetPaths.Add(Archetype.StaticMesh.ToSoftObjectPath());
+
+    for (const TSoftObjectPtr<UMaterialInterface>& Material : Archetype.StoredMaterials)
     {
-        #if	WITH_EDITOR
-             UE_LOG(LogTemp, Error, TEXT("Hovered slot index %d is invalid on UpdateInteriorDrag()"), HoveredSlotIndex);
-        #else
-             UE_LOG(LogTemp, Fatal, TEXT("Hovered slot index %d is invalid on UpdateInteriorDrag()"), HoveredSlotIndex);
-        #endif
-        
-        return;
+        if (!Material.IsNull())
+            AssetPaths.Add(Material.ToSoftObjectPath());
     }
 
-    // In case where item has not left origin slot yet the return early no need to perfmor swap early
-    if (HoveredSlotIndex == OriginSlotIndex)
-    {
-        #if	WITH_EDITOR
-             UE_LOG(LogTemp, Log, TEXT("When hovered slot index %d is the same as original slot index then don't perform interior "), HoveredSlotIndex, OriginSlotIndex);
-        #endif
+    if (AssetPaths.Num() == 0 || !UAssetManager::IsInitialized())
         return;
-    }
 
-    // Perform interior swap in case where theres an item on the lot or when it's empty
-    if (Items[HoveredSlotIndex].WorldObjectReference)
-    { 
-        Items[OriginSlotIndex] = Items[HoveredSlotIndex];
+    ++TrackedAllocationCount;
+    PoppedOutItemAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(AssetPaths), FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+}
 
-        Items[HoveredSlotIndex] = PoppedOutItem;
+void UInventory::SpawnPoppedOutItem(UWorld* World)
+{
+    INVENTORY_SCOPE_CYCLE_COUNTER(STAT_InventoryDropSpawn);
 
-        #if	WITH_EDITOR
-             UE_LOG(LogTemp, Log, TEXT("Swapped item %d with item in slot %d on UpdateInteriorDrag()"), PoppedOutItem.Index, HoveredSlotIndex);
-        #endif
+    if (!ArchetypeTable.IsValidHandle(PoppedOutItem.Archetype))
+        return;
+
+    const FInventoryArchetype& Archetype = ArchetypeTable.Get(PoppedOutItem.Archetype);
+
+    const bool bAreAssetsInFlight = PoppedOutItemAssetsHandle.IsValid() && PoppedOutItemAssetsHandle->IsLoadingInProgress();
+
+    if (!PoppedOutItemAssetsHandle.IsValid() && !AreArchetypeAssetsResident(Archetype))
+    {
+        // No streamable manager to prefetch with, the only option left is loading right here
+        const double LoadStartSeconds = FPlatformTime::Seconds();
+
+        Archetype.StaticMesh.LoadSynchronous();
+        for (const TSoftObjectPtr<UMaterialInterface>& Material : Archetype.StoredMaterials)
+            Material.LoadSynchronous();
+
+        INVENTORY_INC_COUNTER_BY(STAT_InventorySyncAssetLoads, 1 + Archetype.StoredMaterials.Num());
+
+        BlockedLoadSeconds += FPlatformTime::Seconds() - LoadStartSeconds;
+    }
+
+    const FTransform& DropTransform = PoppedOutItem.Transform;
+    const FSoftObjectPath MeshPath = Archetype.StaticMesh.ToSoftObjectPath();
+
+    // A stack is laid out on a square grid centered on the drop point, turned with the drop rotation, so its actors
+    // don't all spawn inside each other. Cells fit the mesh footprint when it's resident, a fixed size otherwise
+    const int32 NumDropColumns = FMath::CeilToInt32(FMath::Sqrt(float(FMath::Max(PoppedOutItem.Quantity, 1))));
+    const int32 NumDropRows = FMath::DivideAndRoundUp(FMath::Max(PoppedOutItem.Quantity, 1), NumDropColumns);
+
+    double DropSpacing = 50.0;
+    if (const UStaticMesh* Mesh = Archetype.StaticMesh.Get())
+    {
+        const FVector Footprint = Mesh->GetBounds().BoxExtent * 2.0 * DropTransform.GetScale3D().GetAbs();
+        DropSpacing = FMath::Max(Footprint.X, Footprint.Y) + 5.0;
+    }
+
+    // Drops come back as the class that was picked up, a plain mesh actor when that class can't be spawned
+    UClass* ActorClass = Archetype.WorldObjectReference.Get();
+    if (!ActorClass || ActorClass->HasAnyClassFlags(CLASS_Abstract))
+        ActorClass = AStaticMeshActor::StaticClass();
+
+    // The whole dragged stack goes to the world, one actor per item
+    TArray<TWeakObjectPtr<AActor>> DroppedActors;
+    DroppedActors.Reserve(PoppedOutItem.Quantity);
+
+    for (int32 DropIndex = 0; DropIndex < PoppedOutItem.Quantity; ++DropIndex)
+    {
+        const FVector CellOffset(
+            (DropIndex / NumDropColumns - (NumDropRows - 1) * 0.5) * DropSpacing,
+            (DropIndex % NumDropColumns - (NumDropColumns - 1) * 0.5) * DropSpacing,
+            0.0);
+
+        FTransform SpawnTransform = DropTransform;
+        SpawnTransform.AddToTranslation(DropTransform.GetRotation().RotateVector(CellOffset));
+
+        // Prefer an actor picked up earlier with the same class and mesh, it only needs its transform and materials re-applied
+        AActor* DroppedActor = ActorPool.Acquire(ActorClass, MeshPath, SpawnTransform);
+        if (DroppedActor)
+        {
+            ApplyItemAssets(DroppedActor->FindComponentByClass<UStaticMeshComponent>(), Archetype);
+        }
+        else
+        {
+            // Begin deferred spawn
+            AActor* SpawnedActor = World->SpawnActorDeferred<AActor>(ActorClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+
+            if (!SpawnedActor)
+                continue;
+
+            ActorPool.NotifyActorSpawned();
+
+            if (UStaticMeshComponent* MeshComp = SpawnedActor->FindComponentByClass<UStaticMeshComponent>())
+            {
+                MeshComp->SetMobility(EComponentMobility::Movable);
+
+                // Set whatever is already resident, a placeholder without mesh otherwise
+                ApplyItemAssets(MeshComp, Archetype);
+            }
+
+            // Finish spawning so BP construction scripts run AFTER our setup
+            UGameplayStatics::FinishSpawningActor(SpawnedActor, SpawnTransform);
+
+            DroppedActor = SpawnedActor;
+        }
+
+        DroppedActors.Add(DroppedActor);
+    }
+
+    if (!bAreAssetsInFlight || DroppedActors.Num() == 0)
+        return;
+
+    // Swap mesh and materials in on the placeholder once they arrive
+    InFlightDropLoads.RemoveAll([](const TSharedPtr<FStreamableHandle>& Load) { return !Load.IsValid() || Load->HasLoadCompleted(); });
+
+    TSharedPtr<FStreamableHandle> DropLoad = PoppedOutItemAssetsHandle;
+    InFlightDropLoads.Add(DropLoad);
+
+    DropLoad->BindCompleteDelegate(FStreamableDelegate::CreateWeakLambda(this, [DroppedActors = MoveTemp(DroppedActors), DroppedArchetype = Archetype]()
+    {
+        for (const TWeakObjectPtr<AActor>& WeakDroppedActor : DroppedActors)
+        {
+            if (AActor* LoadedActor = WeakDroppedActor.Get())
+                ApplyItemAssets(LoadedActor->FindComponentByClass<UStaticMeshComponent>(), DroppedArchetype);
+        }
+    }));
+}
+
+void UInventory::ApplyItemAssets(UStaticMeshComponent* MeshComponent, const FInventoryArchetype& Archetype)
+{
+    if (!MeshComponent)
+        return;
+
+    // Set mesh
+    if (UStaticMesh* Mesh = Archetype.StaticMesh.Get())
+    {
+        MeshComponent->SetStaticMesh(Mesh);
+    }
+
+    // Apply stored materials safely
+    const int32 SlotCount = MeshComponent->GetNumMaterials();
+    for (int32 MaterialIndex = 0; MaterialIndex < Archetype.StoredMaterials.Num() && MaterialIndex < SlotCount; ++MaterialIndex)
+    {
+        if (UMaterialInterface* Mat = Archetype.StoredMaterials[MaterialIndex].Get())
+        {
+            MeshComponent->SetMaterial(MaterialIndex, Mat);
+        }
+    }
+}
+
+void UInventory::AddItem(AActor* ItemActor)
+{
+    INVENTORY_SCOPE_CYCLE_COUNTER(STAT_InventoryAddItem);
+
+    if (RejectClientMutation(TEXT("AddItem")))
+        return;
+
+    const int32 PlacedSlot = PlaceItem(ItemActor);
+    if (PlacedSlot == INDEX_NONE) return;
+
+    RefreshInventory();
+
+    RetireActor(ItemActor, ArchetypeTable.Get(SlotArchetypes[PlacedSlot]).StaticMesh.ToSoftObjectPath(), false);
+}
+
+TArray<int32> UInventory::AddItems(TArrayView<AActor* const> ItemActors)
+{
+    INVENTORY_SCOPE_CYCLE_COUNTER(STAT_InventoryAddItem);
+
+    TArray<int32> PlacedSlots;
+    if (RejectClientMutation(TEXT("AddItems")))
+    {
+        PlacedSlots.Init(INDEX_NONE, ItemActors.Num());
+        return PlacedSlots;
+    }
+
+    PlacedSlots.Reserve(ItemActors.Num());
+
+    TSet<AActor*> SeenActors;
+    SeenActors.Reserve(ItemActors.Num());
+
+    for (AActor* ItemActor : ItemActors)
+    {
+        // The same actor can't be picked up twice in one batch
+        bool bAlreadySeen = false;
+        if (ItemActor)
+            SeenActors.Add(ItemActor, &bAlreadySeen);
+
+        if (!ItemActor || bAlreadySeen)
+        {
+            PlacedSlots.Add(INDEX_NONE);
+            continue;
+        }
+
+        const int32 PlacedSlot = PlaceItem(ItemActor);
+        PlacedSlots.Add(PlacedSlot);
+
+        if (PlacedSlot != INDEX_NONE)
+            RetireActor(ItemActor, ArchetypeTable.Get(SlotArchetypes[PlacedSlot]).StaticMesh.ToSoftObjectPath(), true);
+    }
+
+    // One refresh for the whole batch, only the slots that got filled are dirty
+    RefreshInventory();
+
+    return PlacedSlots;
+}
+
+TFuture<bool> UInventory::SaveSnapshot(const FString& FilePath) const
+{
+    // Gathering has to happen on the game thread, it only copies the slot arrays and archetype paths
+    FInventorySnapshotWriter Writer;
+    Writer.SetNumSlots(NumSlots());
+
+    for (int32 ArchetypeHandle = 0; ArchetypeHandle < ArchetypeTable.Num(); ++ArchetypeHandle)
+        Writer.AddArchetype(ArchetypeTable.Get(ArchetypeHandle));
+
+    for (int32 SlotIndex = 0; SlotIndex < NumSlots(); ++SlotIndex)
+    {
+        if (!IsSlotOccupied(SlotIndex))
+            continue;
+
+        const FInventorySlotEntry Entry = ReadSlot(SlotIndex);
+
+        FInventorySnapshotRecord Record;
+        Record.SlotIndex = SlotIndex;
+        Record.Archetype = Entry.Archetype;
+        Record.ItemId = Entry.ItemId;
+        Record.Quantity = Entry.Quantity;
+        Record.Transform = Entry.Transform;
+        Writer.AddRecord(Record);
+    }
+
+    return Async(EAsyncExecution::ThreadPool, [Writer = MoveTemp(Writer), FilePath]() mutable
+    {
+        TArray<uint8> Bytes;
+        Writer.Encode(Bytes);
+        return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+    });
+}
+
+bool UInventory::LoadSnapshot(const FString& FilePath)
+{
+    // Slots are being moved around by the drag, loading now would pull them from under it
+    if (DragState == EDragState::Pressed || DragState == EDragState::Dragging || RejectClientMutation(TEXT("LoadSnapshot")))
+        return false;
+
+    const double LoadStartSeconds = FPlatformTime::Seconds();
+
+    FInventorySnapshotReader Reader;
+    if (!Reader.Open(FilePath))
+    {
+        #if	WITH_EDITOR
+             UE_LOG(LogInventory, Error, TEXT("Couldn't read inventory snapshot %s"), *FilePath);
+        #endif
+
+        return false;
+    }
+
+    // Snapshot archetypes get interned again, their handles may differ from the saved ones
+    ArchetypeTable.Reset();
+    ResetSlots(NumSlots());
+    ItemLabels.Reset();
+
+    TArray<int32> HandlesBySnapshotArchetype;
+    HandlesBySnapshotArchetype.Reserve(Reader.GetArchetypes().Num());
+    for (const FInventoryArchetype& Archetype : Reader.GetArchetypes())
+        HandlesBySnapshotArchetype.Add(ArchetypeTable.Intern(Archetype));
+
+    TArray<int32> UsedItemIds;
+    UsedItemIds.Reserve(Reader.GetNumRecords());
+
+    TBitArray<> IsSlotLoaded(false, NumSlots());
+
+    TSet<int32> LoadedItemIds;
+    LoadedItemIds.Reserve(Reader.GetNumRecords());
+
+    // No allocator ever hands out an ID this high for a grid this size, anything above is corrupt
+    const int64 ItemIdLimit = int64(NumSlots()) * MaxStackSize;
+
+    int32 NumInvalidRecords = 0;
+    int32 NumDuplicateSlots = 0;
+    int32 NumBadItemIds = 0;
+    int32 NumOversizedStacks = 0;
+
+    for (int32 RecordIndex = 0; RecordIndex < Reader.GetNumRecords(); ++RecordIndex)
+    {
+        const FInventorySnapshotRecord Record = Reader.GetRecord(RecordIndex);
+
+        // Records outside this inventory's grid (saved with a bigger one) are dropped
+        if (!IsValidSlot(Record.SlotIndex) || !HandlesBySnapshotArchetype.IsValidIndex(Record.Archetype) || Record.Quantity <= 0)
+        {
+            ++NumInvalidRecords;
+            continue;
+        }
+
+        // First record wins, a later one for the same slot would leave the overwritten item's ID marked as used
+        if (IsSlotLoaded[Record.SlotIndex])
+        {
+            ++NumDuplicateSlots;
+            continue;
+        }
+
+        // Item IDs have to stay unique and within what the allocator can rebuild from
+        if (Record.ItemId < 0 || Record.ItemId >= ItemIdLimit || LoadedItemIds.Contains(Record.ItemId))
+        {
+            ++NumBadItemIds;
+            continue;
+        }
+
+        // A stack over this inventory's limit can't be represented, refusing it beats silently losing part of it
+        if (Record.Quantity > MaxStackSize)
+        {
+            ++NumOversizedStacks;
+            continue;
+        }
+
+        IsSlotLoaded[Record.SlotIndex] = true;
+        LoadedItemIds.Add(Record.ItemId);
+
+        FInventorySlotEntry Entry;
+        Entry.Archetype = HandlesBySnapshotArchetype[Record.Archetype];
+        Entry.ItemId = Record.ItemId;
+        Entry.Quantity = Record.Quantity;
+        Entry.Transform = Record.Transform;
+        WriteSlot(Record.SlotIndex, Entry);
+
+        UsedItemIds.Add(Record.ItemId);
+    }
+
+    const int32 NumRefusedRecords = NumInvalidRecords + NumDuplicateSlots + NumBadItemIds + NumOversizedStacks;
+    if (NumRefusedRecords > 0)
+    {
+        UE_LOG(LogInventory, Warning, TEXT("Snapshot %s: refused %d of %d records (%d outside the grid or invalid, %d for an already loaded slot, %d with an invalid or duplicate item index, %d over the stack size of %d)"),
+            *FilePath, NumRefusedRecords, Reader.GetNumRecords(), NumInvalidRecords, NumDuplicateSlots, NumBadItemIds, NumOversizedStacks, MaxStackSize);
+    }
+
+    ItemIdAllocator.Rebuild(UsedItemIds);
+
+    RefreshInventory();
+
+    LastSnapshotLoadSeconds = FPlatformTime::Seconds() - LoadStartSeconds;
+    return true;
+}
+
+int32 UInventory::PlaceItem(AActor* ItemActor)
+{
+    if (!ItemActor || ItemActor->IsActorBeingDestroyed()) return INDEX_NONE;
+
+    // Class, mesh and materials go to the archetype table (shared with every identical item)
+    FInventoryArchetype Archetype;
+    Archetype.WorldObjectReference = ItemActor->GetClass();
+
+    // Storing meshes and its multiple materials 
+    if (UStaticMeshComponent* MeshComponent = ItemActor->FindComponentByClass<UStaticMeshComponent>())
+    {
+        if (MeshComponent->GetStaticMesh())
+        {
+            Archetype.StaticMesh = TSoftObjectPtr<UStaticMesh>(MeshComponent->GetStaticMesh());
+        }
+
+        Archetype.StoredMaterials.Reserve(MeshComponent->GetNumMaterials());
+        for (int32 i = 0; i < MeshComponent->GetNumMaterials(); ++i)
+        {
+            UMaterialInterface* MaterialInterface = MeshComponent->GetMaterial(i);
+            if (IsValid(MaterialInterface))
+            {
+                Archetype.StoredMaterials.Add(TSoftObjectPtr<UMaterialInterface>(MaterialInterface));
+            }
+        }
+    }
+
+    // New kinds of items only get interned when there's a slot for them, a full inventory refusing pickups
+    // must not grow the archetype table (a new archetype can't stack, so it needs an empty slot)
+    int32 ArchetypeHandle = ArchetypeTable.Find(Archetype);
+    if (ArchetypeHandle == INDEX_NONE && FindFirstEmptySlot() != INDEX_NONE)
+        ArchetypeHandle = ArchetypeTable.Intern(Archetype);
+
+    // INDEX_NONE has no open stack, PlaceArchetype() refuses it like any other item without room
+    return PlaceArchetype(ArchetypeHandle, ItemActor->GetActorTransform());
+}
+
+int32 UInventory::PlaceArchetype(int32 ArchetypeHandle, const FTransform& Transform)
+{
+    // An identical item already held with room left on its stack takes this one, no new slot or index needed
+    const int32 StackSlot = FindOpenStack(ArchetypeHandle);
+    if (StackSlot != INDEX_NONE)
+    {
+        FInventorySlotEntry Stack = ReadSlot(StackSlot);
+        ++Stack.Quantity;
+        WriteSlot(StackSlot, Stack);
+
+        return StackSlot;
+    }
+
+    int32 EmptySlot = FindFirstEmptySlot();
+    if (EmptySlot == INDEX_NONE)
+    {
+    
+        // When there's no empty slot inventory is full (pickups can hammer this, so it's verbose only)
+        TraceEvent(EInventoryTraceEventType::AddRejected, INDEX_NONE, INDEX_NONE, INDEX_NONE);
+        UE_LOG(LogInventory, Verbose, TEXT("No free slots because inventory is full!"));
+
+        return INDEX_NONE;
+    }
+
+    // Since empty slot is valid then assign this new element accordingly 
+    FInventorySlotEntry NewItem;
+    NewItem.Archetype = ArchetypeHandle;
+    NewItem.Transform = Transform;
+    NewItem.Quantity = 1;
+
+    // Valid index is use for not duplicating indexes, the allocator always gives
+    // the smallest index that is not pressent on any inventory item
+    NewItem.ItemId = ItemIdAllocator.Allocate();
+
+    WriteSlot(EmptySlot, NewItem);
+
+    return EmptySlot;
+}
+
+void UInventory::EnqueueCommand(FInventoryCommand&& Command)
+{
+    PendingCommands.Enqueue(MoveTemp(Command));
+}
+
+int32 UInventory::FlushCommands()
+{
+    check(IsInGameThread());
+
+    // Slots are being moved around by the drag, commands stay queued until it's released
+    if (DragState == EDragState::Pressed || DragState == EDragState::Dragging)
+        return 0;
+
+    LastFlushCommandCount = 0;
+
+    TArray<UInventory*, TInlineAllocator<4>> TouchedInventories;
+
+    FInventoryCommand Command;
+
+    // Replicated clients forward moves to the server, the rest can only come from the server's own queue
+    if (IsReplicatedClient())
+    {
+        int32 NumDroppedCommands = 0;
+        while (PendingCommands.Dequeue(Command))
+        {
+            if (Command.Type == EInventoryCommandType::Move)
+                ReplicationComponent->ServerMoveSlot(Command.Slot, Command.OtherSlot);
+            else
+                ++NumDroppedCommands;
+        }
+
+        UE_CLOG(NumDroppedCommands > 0, LogInventory, Warning, TEXT("Dropped %d queued commands, a replicated client only sends moves to the server"), NumDroppedCommands);
+        return 0;
+    }
+
+    // Held commands came first, once one of them has to wait again nothing queued after it may run either
+    int32 NumHeldApplied = 0;
+    bool bIsDeferred = false;
+    for (; NumHeldApplied < HeldCommands.Num(); ++NumHeldApplied)
+    {
+        const EInventoryCommandResult Result = ApplyCommand(HeldCommands[NumHeldApplied], TouchedInventories);
+        if (Result == EInventoryCommandResult::Deferred)
+        {
+            bIsDeferred = true;
+            break;
+        }
+
+        if (Result == EInventoryCommandResult::Applied)
+            ++LastFlushCommandCount;
+    }
+
+    HeldCommands.RemoveAt(0, NumHeldApplied, EAllowShrinking::No);
+
+    while (!bIsDeferred && PendingCommands.Dequeue(Command))
+    {
+        const EInventoryCommandResult Result = ApplyCommand(Command, TouchedInventories);
+        if (Result == EInventoryCommandResult::Deferred)
+        {
+            HeldCommands.Add(MoveTemp(Command));
+            bIsDeferred = true;
+        }
+        else if (Result == EInventoryCommandResult::Applied)
+        {
+            ++LastFlushCommandCount;
+        }
+    }
+
+    // Whatever producers queued behind a deferred command waits with it, in order
+    if (bIsDeferred)
+    {
+        while (PendingCommands.Dequeue(Command))
+            HeldCommands.Add(MoveTemp(Command));
+    }
+
+    if (LastFlushCommandCount == 0)
+        return 0;
+
+    // Whole batch gets a single refresh, only the slots the commands wrote are dirty
+    RefreshInventory();
+    for (UInventory* TouchedInventory : TouchedInventories)
+        TouchedInventory->RefreshInventory();
+
+    return LastFlushCommandCount;
+}
+
+int32 UInventory::GetLastFlushCommandCount() const
+{
+    return LastFlushCommandCount;
+}
+
+bool UInventory::TickCommandQueue(float DeltaTime)
+{
+    FlushCommands();
+    return true;
+}
+
+EInventoryCommandResult UInventory::ApplyCommand(const FInventoryCommand& Command, TArray<UInventory*, TInlineAllocator<4>>& OutTouchedInventories)
+{
+    switch (Command.Type)
+    {
+        case EInventoryCommandType::Add:
+        {
+            if (!Command.Archetype.WorldObjectReference || Command.Quantity <= 0)
+                return EInventoryCommandResult::Dropped;
+
+            // Interned only when it can be placed, like PlaceItem()
+            int32 ArchetypeHandle = ArchetypeTable.Find(Command.Archetype);
+            if (ArchetypeHandle == INDEX_NONE && FindFirstEmptySlot() != INDEX_NONE)
+                ArchetypeHandle = ArchetypeTable.Intern(Command.Archetype);
+
+            int32 NumPlaced = 0;
+            for (; NumPlaced < Command.Quantity; ++NumPlaced)
+            {
+                // Full, whatever is left of the command is rejected (recorded by PlaceArchetype())
+                if (PlaceArchetype(ArchetypeHandle, Command.Transform) == INDEX_NONE)
+                    break;
+            }
+
+            return NumPlaced > 0 ? EInventoryCommandResult::Applied : EInventoryCommandResult::Dropped;
+        }
+
+        case EInventoryCommandType::Remove:
+        {
+            if (!IsSlotOccupied(Command.Slot))
+                return EInventoryCommandResult::Dropped;
+
+            ReleaseItemId(SlotItemIds[Command.Slot]);
+            ClearSlot(Command.Slot);
+            return EInventoryCommandResult::Applied;
+        }
+
+        case EInventoryCommandType::Move:
+        {
+            if (!IsSlotOccupied(Command.Slot) || !IsValidSlot(Command.OtherSlot) || Command.Slot == Command.OtherSlot)
+                return EInventoryCommandResult::Dropped;
+
+            if (CanMergeStacks(Command.Slot, Command.OtherSlot))
+                MergeStacks(Command.Slot, Command.OtherSlot);
+            else
+                SwapSlots(Command.Slot, Command.OtherSlot);
+            return EInventoryCommandResult::Applied;
+        }
+
+        case EInventoryCommandType::Transfer:
+        {
+            UInventory* Target = Command.TargetInventory.Get();
+            if (!Target || Target == this)
+                return EInventoryCommandResult::Dropped;
+
+            // The target is mid drag, its slots can't be touched until it's released
+            if (Target->DragState == EDragState::Pressed || Target->DragState == EDragState::Dragging)
+                return EInventoryCommandResult::Deferred;
+
+            TArray<int32> ArchetypeRemap;
+            if (MoveSlotBetween(*this, Command.Slot, *Target, Command.OtherSlot, ArchetypeRemap) == INDEX_NONE)
+                return EInventoryCommandResult::Dropped;
+
+            OutTouchedInventories.AddUnique(Target);
+            return EInventoryCommandResult::Applied;
+        }
+
+        default:
+            return EInventoryCommandResult::Dropped;
+    }
+}
+
+void UInventory::RetireActor(AActor* ItemActor, const FSoftObjectPath& MeshPath, bool bDeferDestroy)
+{
+    // Pooled actors are only hidden and deactivated, a later drop brings them back
+    if (ActorPool.Release(ItemActor, MeshPath))
+        return;
+
+    if (bDeferDestroy)
+    {
+        QueueActorDestroy(ItemActor);
+        return;
+    }
+
+    ItemActor->Destroy();
+    ActorPool.NotifyActorDestroyed();
+}
+
+void UInventory::QueueActorDestroy(AActor* ItemActor)
+{
+    // Hidden and without collision it's already gone for gameplay, only the destroy is deferred
+    ItemActor->SetActorHiddenInGame(true);
+    ItemActor->SetActorEnableCollision(false);
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        ItemActor->Destroy();
+        ActorPool.NotifyActorDestroyed();
+        return;
+    }
+
+    // First queued actor schedules the batch
+    if (PendingDestroyActors.Num() == 0)
+        World->GetTimerManager().SetTimerForNextTick(this, &UInventory::DestroyPendingActors);
+
+    PendingDestroyActors.Add(ItemActor);
+}
+
+void UInventory::DestroyPendingActors()
+{
+    for (const TWeakObjectPtr<AActor>& PendingActor : PendingDestroyActors)
+    {
+        if (AActor* ItemActor = PendingActor.Get())
+        {
+            ItemActor->Destroy();
+            ActorPool.NotifyActorDestroyed();
+        }
+    }
+
+    PendingDestroyActors.Reset();
+}
+
+void UInventory::RemoveItem(int32 SlotIndex)
+{
+    if (!IsSlotOccupied(SlotIndex))
+        return;
+
+    // Can't remove the item while it's being dragged around
+    if (DragState == EDragState::Pressed || DragState == EDragState::Dragging)
+    {
+        UE_LOG(LogInventory, Warning, TEXT("Can't remove item from slot %d while dragging"), SlotIndex);
+        return;
+    }
+
+    if (RejectClientMutation(TEXT("RemoveItem")))
+        return;
+
+    ReleaseItemId(SlotItemIds[SlotIndex]);
+    ClearSlot(SlotIndex);
+
+    RefreshInventory();
+}
+
+int32 UInventory::FindHoveredSlot(const FPointerEvent& InMouseEvent)
+{
+    MouseScreenSpacePosition = InMouseEvent.GetScreenSpacePosition();
+
+    return FindHoveredSlotAt(MouseScreenSpacePosition);
+}
+
+int32 UInventory::FindHoveredSlotAt(const FVector2D& AbsolutePosition)
+{
+    INVENTORY_SCOPE_CYCLE_COUNTER(STAT_InventoryFindHoveredSlot);
+
+    // Slot widgets of the overscan row can stick out of the viewport, they only count inside of it
+    if (GridViewport && !GridViewport->GetCachedGeometry().IsUnderLocation(AbsolutePosition))
+        return INDEX_NONE;
+
+    // Leaf grid knows its own layout, no slot rects needed
+    if (LeafGrid)
+    {
+        const int32 LeafSlotIndex = WidgetSlotToItemSlot(LeafGrid->GetSlotAt(AbsolutePosition));
+
+        if (LeafSlotIndex != HoveredSlotIndex)
+            TraceEvent(EInventoryTraceEventType::HoverChanged, LeafSlotIndex, HoveredSlotIndex, INDEX_NONE);
+
+        return LeafSlotIndex;
+    }
+
+    // Slot rects only get re-read from the widgets when the grid geometry changed (which includes scrolling)
+    if (!bIsSlotRectTableValid || IsSlotRectTableStale())
+        RebuildSlotRectTable();
+
+    const int32 NearestSlotIndex = WidgetSlotToItemSlot(FindSlotAtPosition(AbsolutePosition));
+
+    if (NearestSlotIndex != HoveredSlotIndex)
+        TraceEvent(EInventoryTraceEventType::HoverChanged, NearestSlotIndex, HoveredSlotIndex, INDEX_NONE);
+
+    return NearestSlotIndex;
+}
+
+void UInventory::RebuildSlotRectTable()
+{
+    const int32 SlotCount = Slots.Num();
+
+    // Padding entries have inverted bounds so they can never contain the mouse
+    const int32 PaddedSlotCount = Align(SlotCount, 4);
+    SlotRectMinX.Init(FLT_MAX, PaddedSlotCount);
+    SlotRectMinY.Init(FLT_MAX, PaddedSlotCount);
+    SlotRectMaxX.Init(-FLT_MAX, PaddedSlotCount);
+    SlotRectMaxY.Init(-FLT_MAX, PaddedSlotCount);
+
+    bIsSlotRectTableValid = false;
+    bAreSlotRectsUniform = false;
+
+    if (!Grid || SlotCount == 0)
+        return;
+
+    const FGeometry& GridGeometry = Grid->GetCachedGeometry();
+    SlotRectGridPosition = GridGeometry.GetAbsolutePosition();
+    SlotRectGridSize = GridGeometry.GetAbsoluteSize();
+
+    bool bHasUnlaidOutSlot = false;
+
+    for (int32 SlotIndex = 0; SlotIndex < SlotCount; ++SlotIndex)
+    {
+        // Cheking whether current slot is a valid slot index and it exist as an index on the slot array 
+        if (!Slots.IsValidIndex(SlotIndex) || !Slots[SlotIndex])
+        {
+            UE_LOG(LogInventory, Error, TEXT("Slot index %d is invalid on RebuildSlotRectTable()"), SlotIndex);
+            continue;
+        }
+
+        // Track slot geometry in order to check whether mouse is within slot bounds
+        const FGeometry& SlotGeometry = Slots[SlotIndex]->GetCachedGeometry();
+        const FVector2D SlotAbsoluteTopLeft = SlotGeometry.GetAbsolutePosition();
+        const FVector2D SlotAbsoluteBottomRight = SlotAbsoluteTopLeft + SlotGeometry.GetAbsoluteSize();
+
+        bHasUnlaidOutSlot |= SlotGeometry.GetLocalSize().IsNearlyZero();
+
+        SlotRectMinX[SlotIndex] = SlotAbsoluteTopLeft.X;
+        SlotRectMinY[SlotIndex] = SlotAbsoluteTopLeft.Y;
+        SlotRectMaxX[SlotIndex] = SlotAbsoluteBottomRight.X;
+        SlotRectMaxY[SlotIndex] = SlotAbsoluteBottomRight.Y;
+    }
+
+    // Slots that haven't been laid out yet keep the table invalid so the next lookup retries
+    bIsSlotRectTableValid = !bHasUnlaidOutSlot;
+    if (!bIsSlotRectTableValid)
+        return;
+
+    // Derive the lattice from the first slot and its right and bottom neighbours
+    SlotLatticeOrigin = FVector2D(SlotRectMinX[0], SlotRectMinY[0]);
+    SlotLatticeSize = FVector2D(SlotRectMaxX[0] - SlotRectMinX[0], SlotRectMaxY[0] - SlotRectMinY[0]);
+    SlotLatticePitch.X = MaxColumns > 1 ? SlotRectMinX[1] - SlotRectMinX[0] : SlotLatticeSize.X;
+    SlotLatticePitch.Y = NumWidgetRows > 1 ? SlotRectMinY[MaxColumns] - SlotRectMinY[0] : SlotLatticeSize.Y;
+
+    if (SlotLatticePitch.X < SlotLatticeSize.X || SlotLatticePitch.Y < SlotLatticeSize.Y)
+        return;
+
+    // Every slot has to sit exactly where the lattice predicts for arithmetic lookup to be valid
+    constexpr float LatticeTolerance = 0.5f;
+    for (int32 SlotIndex = 0; SlotIndex < SlotCount; ++SlotIndex)
+    {
+        const float ExpectedMinX = SlotLatticeOrigin.X + (SlotIndex % MaxColumns) * SlotLatticePitch.X;
+        const float ExpectedMinY = SlotLatticeOrigin.Y + (SlotIndex / MaxColumns) * SlotLatticePitch.Y;
+
+        if (!FMath::IsNearlyEqual(SlotRectMinX[SlotIndex], ExpectedMinX, LatticeTolerance) ||
+            !FMath::IsNearlyEqual(SlotRectMinY[SlotIndex], ExpectedMinY, LatticeTolerance) ||
+            !FMath::IsNearlyEqual(SlotRectMaxX[SlotIndex] - SlotRectMinX[SlotIndex], SlotLatticeSize.X, LatticeTolerance) ||
+            !FMath::IsNearlyEqual(SlotRectMaxY[SlotIndex] - SlotRectMinY[SlotIndex], SlotLatticeSize.Y, LatticeTolerance))
+        {
+            return;
+        }
+    }
+
+    bAreSlotRectsUniform = true;
+}
+
+bool UInventory::IsSlotRectTableStale() const
+{
+    if (!Grid)
+        return true;
+
+    const FGeometry& GridGeometry = Grid->GetCachedGeometry();
+    return !GridGeometry.GetAbsolutePosition().Equals(SlotRectGridPosition) || !GridGeometry.GetAbsoluteSize().Equals(SlotRectGridSize);
+}
+
+int32 UInventory::FindSlotAtPosition(const FVector2D& AbsolutePosition) const
+{
+    if (!bIsSlotRectTableValid)
+        return INDEX_NONE;
+
+    // Uniform grid: compute row and column straight from the offset and the slot pitch
+    if (bAreSlotRectsUniform)
+    {
+        const FVector2D LatticePosition = AbsolutePosition - SlotLatticeOrigin;
+        if (LatticePosition.X < 0.0f || LatticePosition.Y < 0.0f)
+            return INDEX_NONE;
+
+        const int32 Column = FMath::FloorToInt32(LatticePosition.X / SlotLatticePitch.X);
+        const int32 Row = FMath::FloorToInt32(LatticePosition.Y / SlotLatticePitch.Y);
+        if (Column >= int32(MaxColumns) || Row >= NumWidgetRows)
+            return INDEX_NONE;
+
+        // Mouse is over the padding between two slots rather than a slot
+        if (LatticePosition.X - Column * SlotLatticePitch.X > SlotLatticeSize.X ||
+            LatticePosition.Y - Row * SlotLatticePitch.Y > SlotLatticeSize.Y)
+        {
+            return INDEX_NONE;
+        }
+
+        return Row * MaxColumns + Column;
+    }
+
+    // Non-uniform layout: test four slot rects at a time
+    const VectorRegister4Float PositionX = VectorSetFloat1(float(AbsolutePosition.X));
+    const VectorRegister4Float PositionY = VectorSetFloat1(float(AbsolutePosition.Y));
+
+    for (int32 BaseIndex = 0; BaseIndex < SlotRectMinX.Num(); BaseIndex += 4)
+    {
+        VectorRegister4Float Inside = VectorBitwiseAnd(
+            VectorCompareGE(PositionX, VectorLoad(&SlotRectMinX[BaseIndex])),
+            VectorCompareLE(PositionX, VectorLoad(&SlotRectMaxX[BaseIndex])));
+        Inside = VectorBitwiseAnd(Inside, VectorCompareGE(PositionY, VectorLoad(&SlotRectMinY[BaseIndex])));
+        Inside = VectorBitwiseAnd(Inside, VectorCompareLE(PositionY, VectorLoad(&SlotRectMaxY[BaseIndex])));
+
+        if (const uint32 InsideMask = VectorMaskBits(Inside))
+            return BaseIndex + FMath::CountTrailingZeros(InsideMask);
+    }
+
+    return INDEX_NONE;
+}
+
+void UInventory::RefreshInventory()
+{
+    INVENTORY_SCOPE_CYCLE_COUNTER(STAT_InventoryRefresh);
+
+    LastRefreshRebuiltSlotCount = 0;
+
+    // Nothing changed since the last refresh
+    if (DirtySlots.Find(true) == INDEX_NONE)
+        return;
+
+    // No forced layout here, changed widgets invalidate themselves and hit-testing rebuilds its slot rects
+    // from cached geometry once Slate has laid them out (see RebuildSlotRectTable())
+
+    // Iterate only through the slot widgets in view whose item got touched since the last refresh
+    // (items scrolled out of view have no widget, they get marked dirty again when scrolled back in)
+    for (int32 WidgetSlotIndex = 0; WidgetSlotIndex < NumWidgetSlots(); ++WidgetSlotIndex)
+    {
+        const int32 SlotIndex = WidgetSlotToItemSlot(WidgetSlotIndex);
+
+        if (!IsValidSlot(SlotIndex) || !DirtySlots[SlotIndex])
+            continue;
+
+        // Leaf grid cells are plain data, a changed one only repaints the grid
+        if (LeafGrid)
+        {
+            const bool bShowsItem = IsSlotOccupied(SlotIndex) && !(DragState == EDragState::Dragging && SlotIndex == OriginSlotIndex);
+            LeafGrid->SetSlot(WidgetSlotIndex, bShowsItem, bShowsItem ? GetItemLabel(SlotItemIds[SlotIndex], SlotQuantities[SlotIndex]) : FText::GetEmpty());
+
+            ++LastRefreshRebuiltSlotCount;
+            continue;
+        }
+
+        // Get slot and its size 
+        UBorder* SlotBorder = Slots[WidgetSlotIndex].Get();
+        if (!SlotBorder) continue;
+
+        if (!SlotIcons.IsValidIndex(WidgetSlotIndex) || !SlotIcons[WidgetSlotIndex].Overlay) continue;
+
+        ++LastRefreshRebuiltSlotCount;
+
+        // Hide the original slot icon when it's empty due item dragging to not show an item
+        // on the mouse and on the grid
+        const bool bIsDraggedFromSlot = DragState == EDragState::Dragging && SlotIndex == OriginSlotIndex;
+
+        // Update the persistent icon of occupied slots, hide it on empty ones
+        if (IsSlotOccupied(SlotIndex) && !bIsDraggedFromSlot)
+            CreateItemIcon(SlotIndex);
+        else
+            SlotIcons[WidgetSlotIndex].Overlay->SetVisibility(ESlateVisibility::Hidden);
+
+        SlotBorder->SetVisibility(ESlateVisibility::Visible);
+    }
+
+    // Every dirty slot is now up to date
+    DirtySlots.SetRange(0, DirtySlots.Num(), false);
+
+    INVENTORY_INC_COUNTER_BY(STAT_InventorySlotsRebuilt, LastRefreshRebuiltSlotCount);
+}
+
+void UInventory::MarkSlotDirty(int32 SlotIndex)
+{
+    if (DirtySlots.IsValidIndex(SlotIndex))
+        DirtySlots[SlotIndex] = true;
+}
+
+bool UInventory::IsReplicatedClient() const
+{
+    const UInventoryReplicationComponent* Replication = ReplicationComponent.Get();
+    return Replication && !Replication->HasAuthority();
+}
+
+bool UInventory::RejectClientMutation(const TCHAR* Operation) const
+{
+    if (!IsReplicatedClient())
+        return false;
+
+    UE_LOG(LogInventory, Warning, TEXT("%s ignored, a replicated client's slots only change through the server"), Operation);
+    return true;
+}
+
+void UInventory::OnSlotChanged(int32 SlotIndex)
+{
+    if (!IsValidSlot(SlotIndex))
+        return;
+
+    MarkSlotDirty(SlotIndex);
+    OccupiedSlots.Set(SlotIndex, IsSlotOccupied(SlotIndex));
+    bIsItemsViewStale = true;
+
+    // Only the server pushes, the component ignores this on clients
+    if (UInventoryReplicationComponent* Replication = ReplicationComponent.Get())
+        Replication->PushSlot(SlotIndex, ReadSlot(SlotIndex), ArchetypeTable);
+}
+
+void UInventory::MarkAllSlotsDirty()
+{
+    DirtySlots.Init(true, NumSlots());
+}
+
+int32 UInventory::NumSlots() const
+{
+    return SlotArchetypes.Num();
+}
+
+bool UInventory::IsValidSlot(int32 SlotIndex) const
+{
+    return SlotArchetypes.IsValidIndex(SlotIndex);
+}
+
+bool UInventory::IsSlotOccupied(int32 SlotIndex) const
+{
+    return IsValidSlot(SlotIndex) && SlotArchetypes[SlotIndex] != INDEX_NONE;
+}
+
+void UInventory::ResetSlots(int32 NewNumSlots)
+{
+    SlotArchetypes.Init(INDEX_NONE, NewNumSlots);
+    SlotItemIds.Init(INDEX_NONE, NewNumSlots);
+    SlotTransforms.Init(FTransform::Identity, NewNumSlots);
+    SlotQuantities.Init(0, NewNumSlots);
+    OpenStacksByArchetype.Reset();
+    SlotsByArchetype.Reset();
+    QuantityByArchetype.Reset();
+    SlotPositionsInArchetype.Init(INDEX_NONE, NewNumSlots);
+
+    DirtySlots.Init(true, NewNumSlots);
+    OccupiedSlots.Init(NewNumSlots);
+    bIsItemsViewStale = true;
+
+    if (UInventoryReplicationComponent* Replication = ReplicationComponent.Get())
+        Replication->ResetSlots(NewNumSlots);
+}
+
+FInventorySlotEntry UInventory::ReadSlot(int32 SlotIndex) const
+{
+    FInventorySlotEntry Entry;
+    if (IsValidSlot(SlotIndex))
+    {
+        Entry.Archetype = SlotArchetypes[SlotIndex];
+        Entry.ItemId = SlotItemIds[SlotIndex];
+        Entry.Transform = SlotTransforms[SlotIndex];
+        Entry.Quantity = SlotQuantities[SlotIndex];
+    }
+    return Entry;
+}
+
+void UInventory::WriteSlot(int32 SlotIndex, const FInventorySlotEntry& Entry)
+{
+    if (!IsValidSlot(SlotIndex))
+        return;
+
+    UnlinkSlot(SlotIndex);
+
+    SlotArchetypes[SlotIndex] = Entry.Archetype;
+    SlotItemIds[SlotIndex] = Entry.ItemId;
+    SlotTransforms[SlotIndex] = Entry.Transform;
+    SlotQuantities[SlotIndex] = Entry.Quantity;
+
+    LinkSlot(SlotIndex);
+
+    OnSlotChanged(SlotIndex);
+}
+
+void UInventory::ClearSlot(int32 SlotIndex)
+{
+    WriteSlot(SlotIndex, FInventorySlotEntry());
+}
+
+void UInventory::SwapSlots(int32 FirstSlotIndex, int32 SecondSlotIndex)
+{
+    if (!IsValidSlot(FirstSlotIndex) || !IsValidSlot(SecondSlotIndex) || FirstSlotIndex == SecondSlotIndex)
+        return;
+
+    UnlinkSlot(FirstSlotIndex);
+    UnlinkSlot(SecondSlotIndex);
+
+    Swap(SlotArchetypes[FirstSlotIndex], SlotArchetypes[SecondSlotIndex]);
+    Swap(SlotItemIds[FirstSlotIndex], SlotItemIds[SecondSlotIndex]);
+    Swap(SlotTransforms[FirstSlotIndex], SlotTransforms[SecondSlotIndex]);
+    Swap(SlotQuantities[FirstSlotIndex], SlotQuantities[SecondSlotIndex]);
+
+    LinkSlot(FirstSlotIndex);
+    LinkSlot(SecondSlotIndex);
+
+    OnSlotChanged(FirstSlotIndex);
+    OnSlotChanged(SecondSlotIndex);
+}
+
+FItem UInventory::MakeItem(const FInventorySlotEntry& Entry) const
+{
+    FItem Item;
+    if (!ArchetypeTable.IsValidHandle(Entry.Archetype))
+        return Item;
+
+    const FInventoryArchetype& Archetype = ArchetypeTable.Get(Entry.Archetype);
+    Item.WorldObjectReference = Archetype.WorldObjectReference;
+    Item.WorldObjectTransform = Entry.Transform;
+    Item.Index = Entry.ItemId;
+    Item.StaticMesh = Archetype.StaticMesh;
+    Item.StoredMaterials = Archetype.StoredMaterials;
+    return Item;
+}
+
+void UInventory::LinkSlot(int32 SlotIndex)
+{
+    IndexSlot(SlotIndex);
+    TrackOpenStack(SlotIndex);
+}
+
+void UInventory::UnlinkSlot(int32 SlotIndex)
+{
+    UntrackOpenStack(SlotIndex);
+    UnindexSlot(SlotIndex);
+}
+
+void UInventory::IndexSlot(int32 SlotIndex)
+{
+    if (!IsSlotOccupied(SlotIndex))
+        return;
+
+    const int32 ArchetypeHandle = SlotArchetypes[SlotIndex];
+    if (!SlotsByArchetype.IsValidIndex(ArchetypeHandle))
+    {
+        SlotsByArchetype.SetNum(ArchetypeHandle + 1);
+        QuantityByArchetype.SetNumZeroed(ArchetypeHandle + 1);
+    }
+
+    SlotPositionsInArchetype[SlotIndex] = SlotsByArchetype[ArchetypeHandle].Add(SlotIndex);
+    QuantityByArchetype[ArchetypeHandle] += SlotQuantities[SlotIndex];
+}
+
+void UInventory::UnindexSlot(int32 SlotIndex)
+{
+    if (!IsSlotOccupied(SlotIndex) || !SlotsByArchetype.IsValidIndex(SlotArchetypes[SlotIndex]))
+        return;
+
+    const int32 ArchetypeHandle = SlotArchetypes[SlotIndex];
+    TArray<int32>& ArchetypeSlots = SlotsByArchetype[ArchetypeHandle];
+    const int32 Position = SlotPositionsInArchetype[SlotIndex];
+
+    // The last slot of the list takes the removed one's place, only its position needs fixing up
+    ArchetypeSlots.RemoveAtSwap(Position, 1, EAllowShrinking::No);
+    if (ArchetypeSlots.IsValidIndex(Position))
+        SlotPositionsInArchetype[ArchetypeSlots[Position]] = Position;
+
+    SlotPositionsInArchetype[SlotIndex] = INDEX_NONE;
+    QuantityByArchetype[ArchetypeHandle] -= SlotQuantities[SlotIndex];
+}
+
+void UInventory::TrackOpenStack(int32 SlotIndex)
+{
+    if (!IsSlotOccupied(SlotIndex) || SlotQuantities[SlotIndex] >= MaxStackSize)
+        return;
+
+    // Archetype handles are dense, so the open stack lists are indexed by handle directly
+    const int32 ArchetypeHandle = SlotArchetypes[SlotIndex];
+    if (!OpenStacksByArchetype.IsValidIndex(ArchetypeHandle))
+        OpenStacksByArchetype.SetNum(ArchetypeHandle + 1);
+
+    OpenStacksByArchetype[ArchetypeHandle].Add(SlotIndex);
+}
+
+void UInventory::UntrackOpenStack(int32 SlotIndex)
+{
+    if (!IsSlotOccupied(SlotIndex) || !OpenStacksByArchetype.IsValidIndex(SlotArchetypes[SlotIndex]))
+        return;
+
+    OpenStacksByArchetype[SlotArchetypes[SlotIndex]].RemoveSingleSwap(SlotIndex, EAllowShrinking::No);
+}
+
+int32 UInventory::FindOpenStack(int32 ArchetypeHandle) const
+{
+    if (!OpenStacksByArchetype.IsValidIndex(ArchetypeHandle) || OpenStacksByArchetype[ArchetypeHandle].Num() == 0)
+        return INDEX_NONE;
+
+    return OpenStacksByArchetype[ArchetypeHandle].Last();
+}
+
+int32 UInventory::SplitStack(int32 SlotIndex)
+{
+    if (!IsSlotOccupied(SlotIndex) || SlotQuantities[SlotIndex] < 2)
+        return INDEX_NONE;
+
+    const int32 EmptySlot = FindFirstEmptySlot();
+    if (EmptySlot == INDEX_NONE)
+        return INDEX_NONE;
+
+    FInventorySlotEntry Remaining = ReadSlot(SlotIndex);
+
+    // The split off half is a separate item so it gets its own index
+    FInventorySlotEntry SplitOff = Remaining;
+    SplitOff.Quantity = Remaining.Quantity / 2;
+    SplitOff.ItemId = ItemIdAllocator.Allocate();
+
+    Remaining.Quantity -= SplitOff.Quantity;
+
+    WriteSlot(SlotIndex, Remaining);
+    WriteSlot(EmptySlot, SplitOff);
+
+    return EmptySlot;
+}
+
+bool UInventory::CanMergeStacks(int32 SourceSlotIndex, int32 TargetSlotIndex) const
+{
+    return SourceSlotIndex != TargetSlotIndex && IsSlotOccupied(SourceSlotIndex) && IsSlotOccupied(TargetSlotIndex)
+        && SlotArchetypes[SourceSlotIndex] == SlotArchetypes[TargetSlotIndex] && SlotQuantities[TargetSlotIndex] < MaxStackSize;
+}
+
+void UInventory::MergeStacks(int32 SourceSlotIndex, int32 TargetSlotIndex)
+{
+    if (!CanMergeStacks(SourceSlotIndex, TargetSlotIndex))
+        return;
+
+    FInventorySlotEntry Source = ReadSlot(SourceSlotIndex);
+    FInventorySlotEntry Target = ReadSlot(TargetSlotIndex);
+
+    const int32 MovedQuantity = FMath::Min(Source.Quantity, MaxStackSize - Target.Quantity);
+    Target.Quantity += MovedQuantity;
+    Source.Quantity -= MovedQuantity;
+
+    WriteSlot(TargetSlotIndex, Target);
+
+    // A fully merged stack stops existing, its index is free again
+    if (Source.Quantity > 0)
+    {
+        WriteSlot(SourceSlotIndex, Source);
+    }
+    else
+    {
+        ReleaseItemId(Source.ItemId);
+        ClearSlot(SourceSlotIndex);
+    }
+}
+
+int32 UInventory::TransferItem(UInventory* Source, int32 SourceSlot, UInventory* Destination, int32 DestinationSlot)
+{
+    if (!Source || !Destination)
+        return INDEX_NONE;
+
+    // Slots are being moved around by a drag, transferring now would pull them from under it
+    for (const UInventory* Inventory : { Source, Destination })
+    {
+        if (Inventory->DragState == EDragState::Pressed || Inventory->DragState == EDragState::Dragging || Inventory->RejectClientMutation(TEXT("TransferItem")))
+            return INDEX_NONE;
+    }
+
+    // Within one inventory it's the same merge or swap a drag does (auto-placing has nothing to do, it's already there)
+    if (Source == Destination)
+    {
+        if (!Source->IsSlotOccupied(SourceSlot) || !Source->IsValidSlot(DestinationSlot) || SourceSlot == DestinationSlot)
+            return INDEX_NONE;
+
+        if (Source->CanMergeStacks(SourceSlot, DestinationSlot))
+            Source->MergeStacks(SourceSlot, DestinationSlot);
+        else
+            Source->SwapSlots(SourceSlot, DestinationSlot);
+
+        Source->RefreshInventory();
+        return DestinationSlot;
+    }
+
+    TArray<int32> ArchetypeRemap;
+    const int32 WrittenSlot = MoveSlotBetween(*Source, SourceSlot, *Destination, DestinationSlot, ArchetypeRemap);
+
+    Source->RefreshInventory();
+    Destination->RefreshInventory();
+
+    return WrittenSlot;
+}
+
+TArray<int32> UInventory::TransferItems(UInventory* Source, TConstArrayView<int32> SourceSlots, UInventory* Destination)
+{
+    TArray<int32> WrittenSlots;
+    WrittenSlots.Init(INDEX_NONE, SourceSlots.Num());
+
+    if (!Source || !Destination || Source == Destination)
+        return WrittenSlots;
+
+    for (const UInventory* Inventory : { Source, Destination })
+    {
+        if (Inventory->DragState == EDragState::Pressed || Inventory->DragState == EDragState::Dragging || Inventory->RejectClientMutation(TEXT("TransferItems")))
+            return WrittenSlots;
+    }
+
+    // Every archetype gets interned into the destination once, however many of its slots move
+    TArray<int32> ArchetypeRemap;
+    ArchetypeRemap.Init(INDEX_NONE, Source->ArchetypeTable.Num());
+
+    for (int32 Position = 0; Position < SourceSlots.Num(); ++Position)
+        WrittenSlots[Position] = MoveSlotBetween(*Source, SourceSlots[Position], *Destination, INDEX_NONE, ArchetypeRemap);
+
+    // One refresh each, only the slots that changed are dirty
+    Source->RefreshInventory();
+    Destination->RefreshInventory();
+
+    return WrittenSlots;
+}
+
+int32 UInventory::ImportArchetype(const UInventory& Source, int32 SourceHandle, TArray<int32>& ArchetypeRemap)
+{
+    const int32 ExistingHandle = FindImportedArchetype(Source, SourceHandle, ArchetypeRemap);
+    if (ExistingHandle != INDEX_NONE)
+        return ExistingHandle;
+
+    return ArchetypeRemap[SourceHandle] = ArchetypeTable.Intern(Source.ArchetypeTable.Get(SourceHandle));
+}
+
+int32 UInventory::FindImportedArchetype(const UInventory& Source, int32 SourceHandle, TArray<int32>& ArchetypeRemap) const
+{
+    while (ArchetypeRemap.Num() <= SourceHandle)
+        ArchetypeRemap.Add(INDEX_NONE);
+
+    int32& Handle = ArchetypeRemap[SourceHandle];
+    if (Handle == INDEX_NONE)
+        Handle = ArchetypeTable.Find(Source.ArchetypeTable.Get(SourceHandle));
+
+    return Handle;
+}
+
+int32 UInventory::MoveSlotBetween(UInventory& Source, int32 SourceSlot, UInventory& Destination, int32 DestinationSlot, TArray<int32>& ArchetypeRemap)
+{
+    if (&Source == &Destination || !Source.IsSlotOccupied(SourceSlot))
+        return INDEX_NONE;
+
+    if (DestinationSlot != INDEX_NONE && !Destination.IsValidSlot(DestinationSlot))
+        return INDEX_NONE;
+
+    // Every way into here (transfers, queued commands, cross-inventory drops) changes both inventories
+    if (Source.RejectClientMutation(TEXT("Transfer")) || Destination.RejectClientMutation(TEXT("Transfer")))
+        return INDEX_NONE;
+
+    // Slots only hold an archetype handle and per-instance data, moving an item never copies its materials
+    FInventorySlotEntry Moving = Source.ReadSlot(SourceSlot);
+    const int32 SourceItemId = Moving.ItemId;
+    const int32 SourceQuantity = Moving.Quantity;
+
+    // Only looked up here, the archetype gets copied into the destination once something is actually written there
+    // (INDEX_NONE matches no open stack and no occupied slot)
+    const int32 DestinationArchetype = Destination.FindImportedArchetype(Source, Moving.Archetype, ArchetypeRemap);
+
+    int32 WrittenSlot = INDEX_NONE;
+
+    // Item indices are unique per inventory, so whatever arrives in an empty slot gets a new one there
+    // A stack bigger than the destination allows only moves what fits
+    auto PlaceInEmptySlot = [&Source, &Destination, &Moving, &ArchetypeRemap](int32 EmptySlot)
+    {
+        FInventorySlotEntry Placed = Moving;
+        Placed.Archetype = Destination.ImportArchetype(Source, Moving.Archetype, ArchetypeRemap);
+        Placed.ItemId = Destination.ItemIdAllocator.Allocate();
+        Placed.Quantity = FMath::Min(Moving.Quantity, Destination.MaxStackSize);
+        Destination.WriteSlot(EmptySlot, Placed);
+        Moving.Quantity -= Placed.Quantity;
+    };
+
+    auto TopUpStack = [&Destination, &Moving](int32 StackSlot)
+    {
+        FInventorySlotEntry Stack = Destination.ReadSlot(StackSlot);
+        const int32 MovedQuantity = FMath::Min(Moving.Quantity, Destination.MaxStackSize - Stack.Quantity);
+        Stack.Quantity += MovedQuantity;
+        Moving.Quantity -= MovedQuantity;
+        Destination.WriteSlot(StackSlot, Stack);
+    };
+
+    if (DestinationSlot == INDEX_NONE)
+    {
+        // Open stacks of the same item first, every top up either fills a stack or empties the moving one
+        for (int32 StackSlot = Destination.FindOpenStack(DestinationArchetype); StackSlot != INDEX_NONE && Moving.Quantity > 0; StackSlot = Destination.FindOpenStack(DestinationArchetype))
+        {
+            TopUpStack(StackSlot);
+            WrittenSlot = StackSlot;
+        }
+
+        if (Moving.Quantity > 0)
+        {
+            const int32 EmptySlot = Destination.FindFirstEmptySlot();
+            if (EmptySlot != INDEX_NONE)
+            {
+                PlaceInEmptySlot(EmptySlot);
+                WrittenSlot = EmptySlot;
+            }
+        }
+    }
+    else if (!Destination.IsSlotOccupied(DestinationSlot))
+    {
+        PlaceInEmptySlot(DestinationSlot);
+        WrittenSlot = DestinationSlot;
+    }
+    else if (Destination.SlotArchetypes[DestinationSlot] == DestinationArchetype)
+    {
+        // A full stack of the same item takes nothing
+        if (Destination.SlotQuantities[DestinationSlot] >= Destination.MaxStackSize)
+            return INDEX_NONE;
+
+        TopUpStack(DestinationSlot);
+        WrittenSlot = DestinationSlot;
+    }
+    else
+    {
+        // Another item: the two trade places, both getting a new index in the inventory they arrive in
+        FInventorySlotEntry Displaced = Destination.ReadSlot(DestinationSlot);
+
+        // Neither stack can be split in a swap, one too big for the other inventory refuses the whole swap
+        if (Moving.Quantity > Destination.MaxStackSize || Displaced.Quantity > Source.MaxStackSize)
+            return INDEX_NONE;
+
+        Destination.ReleaseItemId(Displaced.ItemId);
+        Source.ReleaseItemId(SourceItemId);
+
+        Displaced.Archetype = Source.ArchetypeTable.Intern(Destination.ArchetypeTable.Get(Displaced.Archetype));
+        Displaced.ItemId = Source.ItemIdAllocator.Allocate();
+
+        Moving.Archetype = Destination.ImportArchetype(Source, Moving.Archetype, ArchetypeRemap);
+        Moving.ItemId = Destination.ItemIdAllocator.Allocate();
+
+        Destination.WriteSlot(DestinationSlot, Moving);
+        Source.WriteSlot(SourceSlot, Displaced);
+
+        Source.TraceEvent(EInventoryTraceEventType::Transferred, SourceSlot, DestinationSlot, SourceItemId);
+        return DestinationSlot;
+    }
+
+    if (Moving.Quantity == SourceQuantity)
+        return INDEX_NONE;
+
+    // Whatever didn't fit stays behind, a source stack that moved entirely frees its index
+    if (Moving.Quantity > 0)
+    {
+        Source.WriteSlot(SourceSlot, Moving);
     }
     else
     {
-        Items[OriginSlotIndex] = FItem();
+        Source.ReleaseItemId(SourceItemId);
+        Source.ClearSlot(SourceSlot);
+    }
+
+    Source.TraceEvent(EInventoryTraceEventType::Transferred, SourceSlot, WrittenSlot, SourceItemId);
+    return WrittenSlot;
+}
+
+UInventory* UInventory::FindInventoryAt(const FVector2D& AbsolutePosition) const
+{
+    for (const TWeakObjectPtr<UInventory>& LiveInventory : GetLiveInventories())
+    {
+        UInventory* Inventory = LiveInventory.Get();
+        if (!Inventory || Inventory == this || Inventory->GetWorld() != GetWorld() || !Inventory->IsVisible() || !Inventory->Background)
+            continue;
+
+        if (Inventory->Background->GetCachedGeometry().IsUnderLocation(AbsolutePosition))
+            return Inventory;
+    }
+
+    return nullptr;
+}
+
+int32 UInventory::ItemSlotToWidgetSlot(int32 ItemSlotIndex) const
+{
+    const int32 WidgetSlotIndex = ItemSlotIndex - FirstVisibleRow * int32(MaxColumns);
+    return ItemSlotIndex != INDEX_NONE && WidgetSlotIndex >= 0 && WidgetSlotIndex < NumWidgetSlots() ? WidgetSlotIndex : INDEX_NONE;
+}
+
+int32 UInventory::WidgetSlotToItemSlot(int32 WidgetSlotIndex) const
+{
+    return WidgetSlotIndex >= 0 && WidgetSlotIndex < NumWidgetSlots() ? WidgetSlotIndex + FirstVisibleRow * int32(MaxColumns) : INDEX_NONE;
+}
+
+int32 UInventory::NumWidgetSlots() const
+{
+    return NumWidgetRows * int32(MaxColumns);
+}
+
+void UInventory::SetScrollOffset(float NewScrollOffset)
+{
+    const int32 ScrollableRows = FMath::Max(int32(MaxRows) - int32(VisibleRows), 0);
+    ScrollOffset = FMath::Clamp(NewScrollOffset, 0.0f, ScrollableRows * InventorySlotPitch);
+
+    // Whole rows are scrolled by rebinding the slot widgets to other items
+    const int32 NewFirstVisibleRow = FMath::Clamp(FMath::FloorToInt32(ScrollOffset / InventorySlotPitch), 0, FMath::Max(int32(MaxRows) - NumWidgetRows, 0));
+    if (NewFirstVisibleRow != FirstVisibleRow)
+    {
+        FirstVisibleRow = NewFirstVisibleRow;
+
+        // Every widget now shows another item
+        for (int32 WidgetSlotIndex = 0; WidgetSlotIndex < NumWidgetSlots(); ++WidgetSlotIndex)
+            MarkSlotDirty(WidgetSlotToItemSlot(WidgetSlotIndex));
+
+        RefreshInventory();
+    }
+
+    // What's left is less than a row (or the overscan at the very end), the scroll box moves the grid for that
+    if (GridScrollBox)
+        GridScrollBox->SetScrollOffset(ScrollOffset - FirstVisibleRow * InventorySlotPitch);
+}
+
+void UInventory::InternallyRearrangeItems()
+{
+    INVENTORY_SCOPE_CYCLE_COUNTER(STAT_InventoryRearrange);
+
+    // Returning early if none of these 2 states are true (recorded, this runs per frame so it never logs)
+    if (DragState != EDragState::Dragging && DragState != EDragState::Pressed)
+    {
+        TraceEvent(EInventoryTraceEventType::RearrangeRejected, OriginSlotIndex, HoveredSlotIndex, PoppedOutItem.ItemId);
+        return;
+    }
 
-        Items[HoveredSlotIndex] = PoppedOutItem;
+    // Hovered slot was already resolved by the caller
 
-        #if	WITH_EDITOR
-             UE_LOG(LogTemp, Log, TEXT("Moved item %d to empty slot %d on UpdateInteriorDrag()"), PoppedOutItem.Index, HoveredSlotIndex);
-        #endif
+    // Checking whether hovered slot index is invalid and it doesn't exist as a valid index for the items array 
+    if (HoveredSlotIndex == INDEX_NONE || !IsValidSlot(HoveredSlotIndex))
+    {
+        TraceEvent(EInventoryTraceEventType::RearrangeRejected, OriginSlotIndex, HoveredSlotIndex, PoppedOutItem.ItemId);
+        return;
     }
 
+    // In case where item has not left origin slot yet the return early no need to perfmor swap early
+    if (HoveredSlotIndex == OriginSlotIndex)
+        return;
+
+    // Replicated clients leave their slots alone, the release asks the server for the move instead
+    if (IsReplicatedClient())
+        return;
+
+    // Hovering a stack of the same item keeps the dragged one in place, so releasing there merges the two
+    if (SlotArchetypes[HoveredSlotIndex] == PoppedOutItem.Archetype)
+        return;
+
+    // Perform interior swap in case where theres an item on the lot or when it's empty
+    TraceEvent(EInventoryTraceEventType::Swapped, OriginSlotIndex, HoveredSlotIndex, PoppedOutItem.ItemId);
+
+    // Only the two slots involved in the swap need rebuilding, an empty hovered slot just swaps with an empty entry
+    SwapSlots(OriginSlotIndex, HoveredSlotIndex);
+
    // After swap update origin slot to be the new hovered slot 
    OriginSlotIndex = HoveredSlotIndex;
 
@@ -575,64 +2107,127 @@ void UInventory::InternallyRearrangeItems(const FPointerEvent& MouseEvent)
 
 void UInventory::CreateItemIcon(uint32 SlotIndex)
 {
-    // Check whether slot index is a valid index in both arrays
-    if (!Items.IsValidIndex(SlotIndex) || !Slots.IsValidIndex(SlotIndex))
+    INVENTORY_SCOPE_CYCLE_COUNTER(STAT_InventoryCreateItemIcon);
+
+    // Check whether slot index is a valid item and is bound to a slot widget
+    const int32 WidgetSlotIndex = ItemSlotToWidgetSlot(SlotIndex);
+    if (!IsValidSlot(SlotIndex) || !SlotIcons.IsValidIndex(WidgetSlotIndex))
         return;
 
-    // Get the SizeBox from the border
-    TObjectPtr<USizeBox> SizeBox = Cast<USizeBox>(Slots[SlotIndex]->GetContent());
-    if (!SizeBox)
+    // Icon widgets were built once in Create(), here they only get updated
+    const FItemIconWidgets& Icon = SlotIcons[WidgetSlotIndex];
+    if (!Icon.Overlay || !Icon.Text)
         return;
 
-    // Ensuring that slot contains an item and update it
-    UOverlay* IconOverlay = Cast<UOverlay>(SizeBox->GetContent());
-    if (!IconOverlay)
+    // When there's already an existing item on the inventory slot show its index
+    if (IsSlotOccupied(SlotIndex))
     {
-        IconOverlay = NewObject<UOverlay>(this);
-        IconOverlay->SetVisibility(ESlateVisibility::Visible);
-        SizeBox->SetContent(IconOverlay);
+        SetLabelText(Icon.Text, GetItemLabel(SlotItemIds[SlotIndex], SlotQuantities[SlotIndex]));
+        Icon.Overlay->SetVisibility(ESlateVisibility::Visible);
     }
     else
-        IconOverlay->ClearChildren();
+        Icon.Overlay->SetVisibility(ESlateVisibility::Hidden);
+}
+
+const FText& UInventory::GetItemLabel(int32 ItemId, int32 Quantity)
+{
+    // A single item and a stack of one read the same
+    const int32 LabelQuantity = FMath::Max(Quantity, 1);
+    if (TPair<int32, FText>* Label = ItemLabels.Find(ItemId))
+    {
+        // Only a quantity change formats again, moving an item around never does
+        if (Label->Key != LabelQuantity)
+        {
+            ++TrackedAllocationCount;
+            *Label = TPair<int32, FText>(LabelQuantity, MakeItemLabel(ItemId, LabelQuantity));
+        }
+
+        return Label->Value;
+    }
+
+    ++TrackedAllocationCount;
+    return ItemLabels.Add(ItemId, TPair<int32, FText>(LabelQuantity, MakeItemLabel(ItemId, LabelQuantity))).Value;
+}
+
+void UInventory::ReleaseItemId(int32 ItemId)
+{
+    ItemIdAllocator.Release(ItemId);
+
+    // The index may come back as another item, and the cache stays as big as the set of live indices
+    ItemLabels.Remove(ItemId);
+}
+
+void UInventory::SetLabelText(UTextBlock* LabelText, const FText& Label)
+{
+    // Cached labels are shared, an identical one means the same text data so nothing gets invalidated or copied
+    if (LabelText && !LabelText->GetText().IdenticalTo(Label))
+        LabelText->SetText(Label);
+}
+
+FItemIconWidgets UInventory::BuildItemIconWidgets()
+{
+    FItemIconWidgets Icon;
+
+    Icon.Overlay = NewTrackedWidget<UOverlay>();
+    Icon.Overlay->SetVisibility(ESlateVisibility::Visible);
 
     // Create blue icon and align it
-    UImage* ItemIcon = NewObject<UImage>(this);
-    ItemIcon->SetColorAndOpacity(FLinearColor::Blue);
-    ItemIcon->SetVisibility(ESlateVisibility::Visible);
+    Icon.Image = NewTrackedWidget<UImage>();
+    Icon.Image->SetColorAndOpacity(FLinearColor::Blue);
+    Icon.Image->SetVisibility(ESlateVisibility::Visible);
 
-    if (UOverlaySlot* ImageSlot = IconOverlay->AddChildToOverlay(ItemIcon))
+    if (UOverlaySlot* ImageSlot = Icon.Overlay->AddChildToOverlay(Icon.Image))
     {
         ImageSlot->SetHorizontalAlignment(HAlign_Fill);
         ImageSlot->SetVerticalAlignment(VAlign_Fill);
     }
 
-    // When there's already an existing item on the inventory slot
-    if (Items[SlotIndex].WorldObjectReference)
+    // Red index text centered on top of the icon
+    Icon.Text = NewTrackedWidget<UTextBlock>();
+    Icon.Text->SetVisibility(ESlateVisibility::Visible);
+    Icon.Text->SetColorAndOpacity(FLinearColor::Red);
+    Icon.Text->SetJustification(ETextJustify::Center);
+    Icon.Text->SetFont(FCoreStyle::GetDefaultFontStyle("Regular", 20));
+
+    if (UOverlaySlot* TextSlot = Icon.Overlay->AddChildToOverlay(Icon.Text))
     {
-        UTextBlock* CounterText = NewObject<UTextBlock>(this);
-        CounterText->SetVisibility(ESlateVisibility::Visible);
+        TextSlot->SetHorizontalAlignment(HAlign_Center);
+        TextSlot->SetVerticalAlignment(VAlign_Center);
+    }
 
-        if (UOverlaySlot* TextSlot = IconOverlay->AddChildToOverlay(CounterText))
-        {
-            TextSlot->SetHorizontalAlignment(HAlign_Center);
-            TextSlot->SetVerticalAlignment(VAlign_Center);  // or VAlign_Center if preferred
-        }
+    return Icon;
+}
+
+void UInventory::BuildGhostWidget()
+{
+    if (!Canvas || !Canvas->IsValidLowLevelFast())
+        return;
 
-        CounterText->SetText(FText::AsNumber(Items[SlotIndex].Index));
-        CounterText->SetColorAndOpacity(FLinearColor::Red);
-        CounterText->SetJustification(ETextJustify::Center);
-        CounterText->SetFont(FCoreStyle::GetDefaultFontStyle("Regular", 20));
+    // Built once, parked at the canvas origin and hidden, dragging only moves it through its render translation
+    PoppedOutItemWidget = BuildItemIconWidgets();
+    PoppedOutItemWidget.Overlay->SetVisibility(ESlateVisibility::Hidden);
+
+    if (UCanvasPanelSlot* CanvasSlot = Canvas->AddChildToCanvas(PoppedOutItemWidget.Overlay))
+    {
+        CanvasSlot->SetPosition(FVector2D::ZeroVector);
+        CanvasSlot->SetSize(FVector2D(100.0f, 100.0f));
+        CanvasSlot->SetZOrder(100);
+    }
+    else
+    {
+        UE_LOG(LogInventory, Error, TEXT("Failed to add popped-out widget to canvas"));
     }
 }
 
 int32 UInventory::FindFirstEmptySlot() const
 {
-    for (int32 SlotIndex = 0; SlotIndex < Items.Num(); SlotIndex++)
-    {
-        // When no slot has item the just return that index
-        if (!Items[SlotIndex].WorldObjectReference) return SlotIndex;
-    }
-    return INDEX_NONE;
+    // Occupancy bitmap scans 64 slots per step
+    return OccupiedSlots.FindFirstFree();
+}
+
+int32 UInventory::FindFirstEmptySlotFrom(int32 StartSlot) const
+{
+    return OccupiedSlots.FindFirstFreeFrom(StartSlot);
 }
 
 void UInventory::Create()
@@ -640,9 +2235,9 @@ void UInventory::Create()
     if (!Grid || !WidgetTree)
     {
         #if	WITH_EDITOR
-             UE_LOG(LogTemp, Error, TEXT("Either the Grid or WidgetTree are not properly initialized!"));
+             UE_LOG(LogInventory, Error, TEXT("Either the Grid or WidgetTree are not properly initialized!"));
         #else
-             UE_LOG(LogTemp, Fatal, TEXT("Either the Grid or WidgetTree are not properly initialized!"));
+             UE_LOG(LogInventory, Fatal, TEXT("Either the Grid or WidgetTree are not properly initialized!"));
         #endif
 
         return;
@@ -652,31 +2247,68 @@ void UInventory::Create()
     Grid->ClearChildren();
 
     Slots.Empty();
+
+    SlotIcons.Empty();
     
-    Items.Empty();
+    ArchetypeTable.Reset();
 
+    ItemLabels.Reset();
 
-    // Initialize both array's size to 12 (gotta do this here since the constructor executes before begin play)
-    Items.SetNum(MaxRows * MaxColumns);
-    Slots.SetNum(MaxRows * MaxColumns);
+
+    // Only rows in view (plus overscan) get slot widgets, no matter how many rows the inventory has
+    NumWidgetRows = FMath::Min(int32(MaxRows), int32(VisibleRows + OverscanRows));
+    FirstVisibleRow = 0;
+    ScrollOffset = 0.0f;
+
+    // Initialize array's size (gotta do this here since the constructor executes before begin play)
+    ResetSlots(MaxRows * MaxColumns);
+
+    // Viewport shows VisibleRows, anything beyond scrolls
+    if (GridViewport)
+        GridViewport->SetHeightOverride(FMath::Min(MaxRows, VisibleRows) * InventorySlotPitch);
+
+    if (GridScrollBox)
+        GridScrollBox->SetScrollOffset(0.0f);
+
+    // Freshly created slots all need their icons built
+    MarkAllSlotsDirty();
+    ItemIdAllocator.Reset(NumSlots());
+
+    // New slot widgets, so the cached slot rects are meaningless now
+    bIsSlotRectTableValid = false;
+
+    // Leaf grid only needs its size, its cells get filled by the next refresh
+    if (LeafGrid)
+    {
+        LeafGrid->SetGridSize(MaxColumns, NumWidgetRows);
+        return;
+    }
+
+    Slots.SetNum(NumWidgetSlots());
+    SlotIcons.SetNum(NumWidgetSlots());
 
     // Populate slots within the inventory  
-    for (int32 Rows = 0; Rows < (int32)MaxRows; ++Rows)
+    for (int32 Rows = 0; Rows < NumWidgetRows; ++Rows)
     {
         for (int32 Columns = 0; Columns < (int32)MaxColumns; ++Columns)
         {
             int32 CurrentHoveredSlot = Rows * MaxColumns + Columns;
 
-            UBorder* SlotBorder = NewObject<UBorder>(this);
+            UBorder* SlotBorder = NewTrackedWidget<UBorder>();
             SlotBorder->SetBrushColor(FLinearColor(0.1f, 0.1f, 0.1f, 1.0f));
             SlotBorder->SetVisibility(ESlateVisibility::Visible);
 
-            USizeBox* SizeBox = NewObject<USizeBox>(this);
-            SizeBox->SetWidthOverride(100.0f);
-            SizeBox->SetHeightOverride(100.0f);
+            USizeBox* SizeBox = NewTrackedWidget<USizeBox>();
+            SizeBox->SetWidthOverride(InventorySlotSize);
+            SizeBox->SetHeightOverride(InventorySlotSize);
 
             SlotBorder->SetContent(SizeBox);
 
+            // Every slot owns its icon for its whole lifetime, refreshes only update it
+            SlotIcons[CurrentHoveredSlot] = BuildItemIconWidgets();
+            SlotIcons[CurrentHoveredSlot].Overlay->SetVisibility(ESlateVisibility::Hidden);
+            SizeBox->SetContent(SlotIcons[CurrentHoveredSlot].Overlay);
+
             // Add slots visauls to the grid and set their alignment 
             GridSlot = Grid->AddChildToUniformGrid(SlotBorder, Rows, Columns);
             GridSlot->SetHorizontalAlignment(HAlign_Center);
@@ -684,17 +2316,8 @@ void UInventory::Create()
 
             // Populate slots array with the grey colored border
             Slots[CurrentHoveredSlot] = SlotBorder;
-
-
-            // Forcing slot border and slot size box widgets layout update
-            SlotBorder->ForceLayoutPrepass();
-            SizeBox->ForceLayoutPrepass();
         }
     }
-
-
-    // Forcing grid widget layout update
-    if (Grid) Grid->ForceLayoutPrepass();
 }
 
 void UInventory::Open()
@@ -707,14 +2330,245 @@ void UInventory::Close()
     SetVisibility(ESlateVisibility::Collapsed);
 }
 
+void UInventory::SetGridSize(int32 NewMaxRows, int32 NewMaxColumns)
+{
+    if (NewMaxRows <= 0 || NewMaxColumns <= 0 || DragState == EDragState::Pressed || DragState == EDragState::Dragging || RejectClientMutation(TEXT("SetGridSize")))
+        return;
+
+    MaxRows = NewMaxRows;
+    MaxColumns = NewMaxColumns;
+
+    Create();
+    RefreshInventory();
+}
+
 bool UInventory::IsInventoryFull() const
 {
-    return (FindFirstEmptySlot() == INDEX_NONE);
+    return OccupiedSlots.IsFull();
+}
+
+bool UInventory::IsInventoryEmpty() const
+{
+    return OccupiedSlots.IsEmpty();
+}
+
+int32 UInventory::GetNumOccupiedSlots() const
+{
+    return OccupiedSlots.NumOccupiedSlots();
 }
 
 const TArray<FItem>& UInventory::GetItems() const
 {
-    return Items;
+    // Items are stored as archetype handles plus per-slot arrays, the FItem view is only built when asked for
+    if (bIsItemsViewStale)
+    {
+        ItemsView.SetNum(NumSlots());
+        for (int32 SlotIndex = 0; SlotIndex < NumSlots(); ++SlotIndex)
+            ItemsView[SlotIndex] = MakeItem(ReadSlot(SlotIndex));
+
+        bIsItemsViewStale = false;
+    }
+
+    return ItemsView;
+}
+
+FItem UInventory::GetItem(int32 SlotIndex) const
+{
+    return MakeItem(ReadSlot(SlotIndex));
+}
+
+int32 UInventory::GetItemQuantity(int32 SlotIndex) const
+{
+    return IsValidSlot(SlotIndex) ? SlotQuantities[SlotIndex] : 0;
+}
+
+TArray<int32> UInventory::FindSlotsByClass(TSubclassOf<AActor> ItemClass) const
+{
+    TArray<int32> FoundSlots;
+    for (int32 ArchetypeHandle : ArchetypeTable.GetHandlesByClass(ItemClass))
+    {
+        if (SlotsByArchetype.IsValidIndex(ArchetypeHandle))
+            FoundSlots.Append(SlotsByArchetype[ArchetypeHandle]);
+    }
+
+    return FoundSlots;
+}
+
+int32 UInventory::CountItemsByClass(TSubclassOf<AActor> ItemClass) const
+{
+    int32 Count = 0;
+    for (int32 ArchetypeHandle : ArchetypeTable.GetHandlesByClass(ItemClass))
+    {
+        if (QuantityByArchetype.IsValidIndex(ArchetypeHandle))
+            Count += QuantityByArchetype[ArchetypeHandle];
+    }
+
+    return Count;
+}
+
+TArray<int32> UInventory::FindSlotsByMesh(const TSoftObjectPtr<UStaticMesh>& StaticMesh) const
+{
+    TArray<int32> FoundSlots;
+    for (int32 ArchetypeHandle : ArchetypeTable.GetHandlesByMesh(StaticMesh.ToSoftObjectPath()))
+    {
+        if (SlotsByArchetype.IsValidIndex(ArchetypeHandle))
+            FoundSlots.Append(SlotsByArchetype[ArchetypeHandle]);
+    }
+
+    return FoundSlots;
+}
+
+int32 UInventory::CountItemsByMesh(const TSoftObjectPtr<UStaticMesh>& StaticMesh) const
+{
+    int32 Count = 0;
+    for (int32 ArchetypeHandle : ArchetypeTable.GetHandlesByMesh(StaticMesh.ToSoftObjectPath()))
+    {
+        if (QuantityByArchetype.IsValidIndex(ArchetypeHandle))
+            Count += QuantityByArchetype[ArchetypeHandle];
+    }
+
+    return Count;
+}
+
+void UInventory::SortAndCompact()
+{
+    // By class, then mesh (item index breaks the remaining ties)
+    SortAndCompact([](const FInventoryArchetype& A, const FInventoryArchetype& B)
+    {
+        const FString AClassPath = A.WorldObjectReference ? A.WorldObjectReference->GetPathName() : FString();
+        const FString BClassPath = B.WorldObjectReference ? B.WorldObjectReference->GetPathName() : FString();
+        if (AClassPath != BClassPath)
+            return AClassPath < BClassPath;
+
+        return A.StaticMesh.ToSoftObjectPath().ToString() < B.StaticMesh.ToSoftObjectPath().ToString();
+    });
+}
+
+void UInventory::SortAndCompact(TFunctionRef<bool(const FInventoryArchetype&, const FInventoryArchetype&)> ArchetypeLess)
+{
+    // Slots are being moved around by the drag, sorting now would pull them from under it
+    if (DragState == EDragState::Pressed || DragState == EDragState::Dragging || RejectClientMutation(TEXT("SortAndCompact")))
+        return;
+
+    LastSortMoveCount = 0;
+
+    // Archetypes get ranked once, slots then only compare integers
+    TArray<int32> ArchetypesInOrder;
+    ArchetypesInOrder.Reserve(ArchetypeTable.Num());
+    for (int32 ArchetypeHandle = 0; ArchetypeHandle < ArchetypeTable.Num(); ++ArchetypeHandle)
+        ArchetypesInOrder.Add(ArchetypeHandle);
+
+    Algo::StableSort(ArchetypesInOrder, [this, &ArchetypeLess](int32 A, int32 B)
+    {
+        return ArchetypeLess(ArchetypeTable.Get(A), ArchetypeTable.Get(B));
+    });
+
+    TArray<int32> ArchetypeRanks;
+    ArchetypeRanks.SetNumUninitialized(ArchetypeTable.Num());
+    for (int32 Rank = 0; Rank < ArchetypesInOrder.Num(); ++Rank)
+        ArchetypeRanks[ArchetypesInOrder[Rank]] = Rank;
+
+    const int32 SlotCount = NumSlots();
+    const bool bIsParallel = SlotCount >= InventoryParallelSortMinSlots;
+
+    TArray<FInventorySortKey> Keys;
+    Keys.SetNum(SlotCount);
+
+    auto ExtractKeys = [this, &Keys, &ArchetypeRanks, SlotCount](int32 ChunkIndex)
+    {
+        const int32 Begin = ChunkIndex * InventorySortChunkSize;
+        const int32 End = FMath::Min(Begin + InventorySortChunkSize, SlotCount);
+        for (int32 SlotIndex = Begin; SlotIndex < End; ++SlotIndex)
+        {
+            Keys[SlotIndex].SlotIndex = SlotIndex;
+            if (IsSlotOccupied(SlotIndex))
+                Keys[SlotIndex].Key = (uint64(ArchetypeRanks[SlotArchetypes[SlotIndex]]) << 32) | uint32(SlotItemIds[SlotIndex]);
+        }
+    };
+
+    const int32 NumChunks = FMath::DivideAndRoundUp(SlotCount, InventorySortChunkSize);
+    if (bIsParallel)
+    {
+        ParallelFor(NumChunks, ExtractKeys);
+        ParallelSortKeys(Keys);
+    }
+    else
+    {
+        for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+            ExtractKeys(ChunkIndex);
+
+        Algo::Sort(Keys);
+    }
+
+    // Where every slot's content has to go: occupied slots to their sorted position, the first ones in front
+    const int32 NumOccupied = GetNumOccupiedSlots();
+
+    TArray<int32> Destinations;
+    Destinations.SetNumUninitialized(SlotCount);
+    for (int32 SlotIndex = 0; SlotIndex < SlotCount; ++SlotIndex)
+        Destinations[SlotIndex] = SlotIndex;
+
+    for (int32 Position = 0; Position < NumOccupied; ++Position)
+        Destinations[Keys[Position].SlotIndex] = Position;
+
+    // Empty slots in front trade places with the occupied slots behind that are moving forward,
+    // empty slots already behind stay where they are
+    int32 VacatedSlot = NumOccupied;
+    for (int32 SlotIndex = 0; SlotIndex < NumOccupied; ++SlotIndex)
+    {
+        if (IsSlotOccupied(SlotIndex))
+            continue;
+
+        while (IsSlotOccupied(VacatedSlot) == false)
+            ++VacatedSlot;
+
+        Destinations[SlotIndex] = VacatedSlot++;
+    }
+
+    // Apply the permutation one cycle at a time, every misplaced slot gets written exactly once
+    TBitArray<> IsPlaced(false, SlotCount);
+    for (int32 CycleStart = 0; CycleStart < SlotCount; ++CycleStart)
+    {
+        if (IsPlaced[CycleStart] || Destinations[CycleStart] == CycleStart)
+            continue;
+
+        FInventorySlotEntry Carried = ReadSlot(CycleStart);
+        int32 Current = CycleStart;
+        do
+        {
+            const int32 Next = Destinations[Current];
+            const FInventorySlotEntry Displaced = ReadSlot(Next);
+
+            WriteSlot(Next, Carried);
+            IsPlaced[Next] = true;
+            ++LastSortMoveCount;
+
+            Carried = Displaced;
+            Current = Next;
+        }
+        while (Current != CycleStart);
+    }
+
+    RefreshInventory();
+}
+
+int32 UInventory::GetLastSortMoveCount() const
+{
+    return LastSortMoveCount;
+}
+
+bool UInventory::HasAnyItemOfClasses(const TArray<TSubclassOf<AActor>>& ItemClasses) const
+{
+    for (const TSubclassOf<AActor>& ItemClass : ItemClasses)
+    {
+        for (int32 ArchetypeHandle : ArchetypeTable.GetHandlesByClass(ItemClass))
+        {
+            if (QuantityByArchetype.IsValidIndex(ArchetypeHandle) && QuantityByArchetype[ArchetypeHandle] > 0)
+                return true;
+        }
+    }
+
+    return false;
 }
 
 TArray<TObjectPtr<UBorder>> UInventory::GetSlots() const
@@ -726,3 +2580,195 @@ TObjectPtr<UUniformGridPanel> UInventory::GetGrid() const
 {
     return Grid.Get();
 }
+
+int32 UInventory::GetFirstVisibleRow() const
+{
+    return FirstVisibleRow;
+}
+
+int32 UInventory::GetLastRefreshRebuiltSlotCount() const
+{
+    return LastRefreshRebuiltSlotCount;
+}
+
+int32 UInventory::GetLastDragAllocationCount() const
+{
+    return LastDragAllocationCount;
+}
+
+double UInventory::GetBlockedLoadSeconds() const
+{
+    return BlockedLoadSeconds;
+}
+
+double UInventory::GetLastSnapshotLoadSeconds() const
+{
+    return LastSnapshotLoadSeconds;
+}
+
+int32 UInventory::GetLastFrameMouseMoveEvents() const
+{
+    return LastFrameMouseMoveEvents;
+}
+
+int64 UInventory::GetTotalMouseMoveEvents() const
+{
+    return TotalMouseMoveEvents;
+}
+
+int64 UInventory::GetTotalDragUpdates() const
+{
+    return TotalDragUpdates;
+}
+
+TArray<TPair<FString, double>> UInventory::GetPerfCounters() const
+{
+    const FInventoryActorPoolStats& PoolStats = ActorPool.GetStats();
+
+    TArray<TPair<FString, double>> Counters;
+    Counters.Reserve(17);
+
+    Counters.Emplace(TEXT("NumSlots"), NumSlots());
+    Counters.Emplace(TEXT("NumOccupiedSlots"), GetNumOccupiedSlots());
+    Counters.Emplace(TEXT("NumArchetypes"), ArchetypeTable.Num());
+    Counters.Emplace(TEXT("NumSlotWidgets"), Slots.Num());
+    Counters.Emplace(TEXT("LeafGridDrawElements"), LeafGrid ? LeafGrid->GetLastPaintDrawElementCount() : 0);
+    Counters.Emplace(TEXT("WidgetAllocationCount"), WidgetAllocationCount);
+    Counters.Emplace(TEXT("TrackedAllocationCount"), TrackedAllocationCount);
+    Counters.Emplace(TEXT("LastDragAllocationCount"), LastDragAllocationCount);
+    Counters.Emplace(TEXT("LastRefreshRebuiltSlotCount"), LastRefreshRebuiltSlotCount);
+    Counters.Emplace(TEXT("TotalMouseMoveEvents"), double(TotalMouseMoveEvents));
+    Counters.Emplace(TEXT("TotalDragUpdates"), double(TotalDragUpdates));
+    Counters.Emplace(TEXT("LastFlushCommandCount"), LastFlushCommandCount);
+    Counters.Emplace(TEXT("BlockedLoadSeconds"), BlockedLoadSeconds);
+    Counters.Emplace(TEXT("LastSnapshotLoadSeconds"), LastSnapshotLoadSeconds);
+    Counters.Emplace(TEXT("ActorPoolHitRate"), PoolStats.GetHitRate());
+    Counters.Emplace(TEXT("ActorPoolSpawnCount"), PoolStats.SpawnCount);
+    Counters.Emplace(TEXT("ActorPoolDestroyCount"), PoolStats.DestroyCount);
+
+    return Counters;
+}
+
+void UInventory::TraceEvent(EInventoryTraceEventType Type, int32 SlotIndex, int32 OtherSlotIndex, int32 ItemId) const
+{
+#if INVENTORY_TRACE_RING_ENABLED
+    FInventoryTraceEvent Event;
+    Event.InventoryId = GetUniqueID();
+    Event.SlotIndex = SlotIndex;
+    Event.OtherSlotIndex = OtherSlotIndex;
+    Event.ItemId = ItemId;
+    Event.Type = Type;
+    Event.DragState = uint8(DragState);
+
+    FInventoryTraceRing::Get().Record(Event);
+#endif
+}
+
+#if INVENTORY_TRACE_RING_ENABLED
+// Inventory.DumpTrace: prints the most recent hot-path events of every inventory, oldest first (attach to bug reports)
+static FAutoConsoleCommand InventoryDumpTraceCommand(
+    TEXT("Inventory.DumpTrace"),
+    TEXT("Prints the inventory trace ring buffer (hover changes, drags, swaps, merges, drops) to the log"),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        TArray<FInventoryTraceEvent> Events;
+        FInventoryTraceRing::Get().Snapshot(Events);
+
+        const uint64 LastCycles = Events.Num() > 0 ? Events.Last().Cycles : 0;
+
+        UE_LOG(LogInventory, Display, TEXT("Inventory trace, %d events (times relative to the last one)"), Events.Num());
+        for (const FInventoryTraceEvent& Event : Events)
+        {
+            UE_LOG(LogInventory, Display, TEXT("  %10.3f ms  inventory %u  %-17s slot %d  other %d  item %d  drag state %u"),
+                -FPlatformTime::ToMilliseconds64(LastCycles - Event.Cycles), Event.InventoryId, LexToString(Event.Type),
+                Event.SlotIndex, Event.OtherSlotIndex, Event.ItemId, uint32(Event.DragState));
+        }
+    }));
+#endif
+
+#if INVENTORY_STATS_ENABLED
+// Inventory.PerfReport [json]: writes the counters of every live inventory to Saved/Profiling, one row (or object) per inventory
+static FAutoConsoleCommandWithWorldAndArgs InventoryPerfReportCommand(
+    TEXT("Inventory.PerfReport"),
+    TEXT("Writes every live inventory's perf counters to Saved/Profiling/InventoryPerf.csv, or .json with the 'json' argument"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        const bool bAsJson = Args.Contains(TEXT("json"));
+
+        FString Report;
+        bool bHasHeader = false;
+        for (TObjectIterator<UInventory> It; It; ++It)
+        {
+            if (It->HasAnyFlags(RF_ClassDefaultObject) || (World && It->GetWorld() != World))
+                continue;
+
+            const TArray<TPair<FString, double>> Counters = It->GetPerfCounters();
+
+            if (bAsJson)
+            {
+                Report += Report.IsEmpty() ? TEXT("[\n") : TEXT(",\n");
+                Report += FString::Printf(TEXT("  { \"Inventory\": \"%s\""), *It->GetName());
+                for (const TPair<FString, double>& Counter : Counters)
+                    Report += FString::Printf(TEXT(", \"%s\": %g"), *Counter.Key, Counter.Value);
+                Report += TEXT(" }");
+                continue;
+            }
+
+            if (!bHasHeader)
+            {
+                Report += TEXT("Inventory");
+                for (const TPair<FString, double>& Counter : Counters)
+                    Report += TEXT(",") + Counter.Key;
+                Report += TEXT("\n");
+                bHasHeader = true;
+            }
+
+            Report += It->GetName();
+            for (const TPair<FString, double>& Counter : Counters)
+                Report += FString::Printf(TEXT(",%g"), Counter.Value);
+            Report += TEXT("\n");
+        }
+
+        if (bAsJson)
+            Report += Report.IsEmpty() ? TEXT("[]\n") : TEXT("\n]\n");
+
+        const FString ReportPath = FPaths::ProfilingDir() / (bAsJson ? TEXT("InventoryPerf.json") : TEXT("InventoryPerf.csv"));
+        if (FFileHelper::SaveStringToFile(Report, *ReportPath))
+            UE_LOG(LogInventory, Log, TEXT("Inventory perf report written to %s"), *ReportPath);
+    }));
+#endif
+
+void UInventory::BindReplication(UInventoryReplicationComponent* Component)
+{
+    ReplicationComponent = Component;
+    if (!Component)
+        return;
+
+    Component->SetBoundInventory(this);
+
+    // Server seeds the replicated slots with the current content (no-ops on clients, they wait for it instead)
+    Component->ResetSlots(NumSlots());
+    for (int32 SlotIndex = 0; SlotIndex < NumSlots(); ++SlotIndex)
+    {
+        if (IsSlotOccupied(SlotIndex))
+            Component->PushSlot(SlotIndex, ReadSlot(SlotIndex), ArchetypeTable);
+    }
+}
+
+int32 UInventory::InternReplicatedArchetype(const FInventoryArchetype& Archetype)
+{
+    return ArchetypeTable.Intern(Archetype);
+}
+
+void UInventory::ApplyReplicatedSlots(const TMap<int32, FInventorySlotEntry>& ChangedSlots)
+{
+    for (const TPair<int32, FInventorySlotEntry>& ChangedSlot : ChangedSlots)
+        WriteSlot(ChangedSlot.Key, ChangedSlot.Value);
+
+    RefreshInventory();
+}
+
+const FInventoryActorPoolStats& UInventory::GetActorPoolStats() const
+{
+    return ActorPool.GetStats();
+}
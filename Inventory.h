@@ -15,12 +15,30 @@
 #include "Components/OverlaySlot.h"
 #include "Components/VerticalBox.h"
 #include "Components/VerticalBoxSlot.h"
+#include "Components/ScrollBox.h"
+#include "Components/InvalidationBox.h"
 #include "Item.h"
+#include "InventoryArchetype.h"
+#include "InventorySlotBitmap.h"
+#include "InventoryIdAllocator.h"
+#include "InventoryActorPool.h"
+#include "InventorySnapshot.h"
+#include "InventoryStats.h"
+#include "InventoryLog.h"
+#include "InventoryTraceRing.h"
+#include "InventoryCommand.h"
+#include "InventoryGridWidget.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
 #include "Brushes/SlateColorBrush.h"
 #include "Engine/StaticMeshActor.h"
+#include "Engine/StreamableManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Inventory.generated.h"
 
+class UInventoryReplicationComponent;
+
 // Drag state is responsible for tracking all the stages of drag interations
 enum class EDragState : uint8
 {
@@ -30,6 +48,22 @@ enum class EDragState : uint8
     Dropped   // Item has been dropped
 };
 
+// Icon widgets for one item (blue image + red index text), built once and then only updated
+USTRUCT()
+struct FItemIconWidgets
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TObjectPtr<UOverlay> Overlay = nullptr;
+
+    UPROPERTY()
+    TObjectPtr<UImage> Image = nullptr;
+
+    UPROPERTY()
+    TObjectPtr<UTextBlock> Text = nullptr;
+};
+
 // Inventory user widget calls (Main class)
 UCLASS()
 class UInventory : public UUserWidget
@@ -45,11 +79,21 @@ public:
     // Called when the widget is constructed or reconstructed
     virtual void NativeConstruct() override;
 
+    // Called when the widget is removed from its parent
+    virtual void NativeDestruct() override;
+
+    // Stops draining the command queue
+    virtual void BeginDestroy() override;
+
     // ******************** Mouse events for drag detection ********************
 
     virtual FReply NativeOnMouseButtonDown(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
     virtual FReply NativeOnMouseMove(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
     virtual FReply NativeOnMouseButtonUp(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+    virtual FReply NativeOnMouseWheel(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+
+    // Called every frame, drives auto-scroll while dragging near the grid edges
+    virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 
     // ******************** Open and close for toggling Inventory via Tab ********************
 
@@ -59,43 +103,319 @@ public:
     UFUNCTION()
     void Close();
 
+    // Rebuilds the grid with a new size, emptying the inventory (refused while an item is pressed or dragged)
+    UFUNCTION()
+    void SetGridSize(int32 NewMaxRows, int32 NewMaxColumns);
+
     // ***************************************************************************************
 
     // Adds an item to the inventory
+    // Items identical to one already held go onto its stack first, a new slot is only taken when every such stack is full
     UFUNCTION()
     void AddItem(AActor* ItemActor);
 
-    // Checks if the inventory is full
+    // Adds a batch of items with a single refresh, source actors get destroyed together on the next tick
+    // Returns for every actor the slot it was placed in, or INDEX_NONE when rejected (inventory full)
+    TArray<int32> AddItems(TArrayView<AActor* const> ItemActors);
+
+    // Removes the item (or whole stack) held in a slot and releases its unique index
+    UFUNCTION()
+    void RemoveItem(int32 SlotIndex);
+
+    // Writes every occupied slot to a compact binary snapshot, encoding and file IO run on a background thread
+    TFuture<bool> SaveSnapshot(const FString& FilePath) const;
+
+    // Replaces the inventory content with a snapshot (memory mapped, records decoded one at a time)
+    // Records that don't fit this inventory (slot, item index or stack size) are refused and logged
+    // Returns false when the file can't be read or a drag is in progress
+    bool LoadSnapshot(const FString& FilePath);
+
+    // Checks if every slot is occupied (an item can still be added when it fits on an existing stack)
     UFUNCTION()
     bool IsInventoryFull() const;
 
-    // Returns a reference to the item array
+    // Checks if the inventory holds no item at all
+    UFUNCTION()
+    bool IsInventoryEmpty() const;
+
+    // Returns how many slots currently hold an item (a stack counts as one)
+    UFUNCTION()
+    int32 GetNumOccupiedSlots() const;
+
+    // Finds the first empty slot at or after StartSlot (for auto-placement), INDEX_NONE when there's none
+    UFUNCTION()
+    int32 FindFirstEmptySlotFrom(int32 StartSlot) const;
+
+    // Returns every slot as an FItem (rebuilt from the archetype table only when something changed since the last call)
     UFUNCTION()
     const TArray<FItem>& GetItems() const;
 
-    // Returns the array of inventory slots
+    // Returns the item held in a single slot
+    UFUNCTION()
+    FItem GetItem(int32 SlotIndex) const;
+
+    // Returns how many identical items are stacked in a slot, 0 when the slot is empty
+    UFUNCTION()
+    int32 GetItemQuantity(int32 SlotIndex) const;
+
+    // ************* Indexed queries (exact class or mesh match, cost depends on the matches, not the inventory size) *************
+
+    // Returns every slot holding items of exactly this class
+    UFUNCTION()
+    TArray<int32> FindSlotsByClass(TSubclassOf<AActor> ItemClass) const;
+
+    // Returns how many items of exactly this class are held, stacks count every item
+    UFUNCTION()
+    int32 CountItemsByClass(TSubclassOf<AActor> ItemClass) const;
+
+    // Returns every slot holding items with this mesh
+    UFUNCTION()
+    TArray<int32> FindSlotsByMesh(const TSoftObjectPtr<UStaticMesh>& StaticMesh) const;
+
+    // Returns how many items with this mesh are held, stacks count every item
+    UFUNCTION()
+    int32 CountItemsByMesh(const TSoftObjectPtr<UStaticMesh>& StaticMesh) const;
+
+    // Checks whether at least one item of any of these classes is held
+    UFUNCTION()
+    bool HasAnyItemOfClasses(const TArray<TSubclassOf<AActor>>& ItemClasses) const;
+
+    // Sorts items by class, then mesh, then index and packs every empty slot to the end, with a single refresh
+    void SortAndCompact();
+
+    // Same with a custom archetype order (ties between identical archetypes are broken by item index)
+    // Items are moved in place along the permutation's cycles, so every misplaced slot gets written once
+    void SortAndCompact(TFunctionRef<bool(const FInventoryArchetype&, const FInventoryArchetype&)> ArchetypeLess);
+
+    // Returns how many slot writes the last SortAndCompact() needed
+    int32 GetLastSortMoveCount() const;
+
+    // ************* Transfers between inventories (backpack, chest, vendor, stash...) *************
+
+    // Moves the item (or stack) in SourceSlot to DestinationSlot of another inventory, no world actor involved
+    // An empty slot takes the whole stack, a stack of the same item takes what fits and any other item trades places
+    // DestinationSlot INDEX_NONE tops up open stacks first and puts the rest in the first empty slot
+    // Only the slots involved get refreshed, returns the destination slot written last or INDEX_NONE when nothing moved
+    UFUNCTION()
+    static int32 TransferItem(UInventory* Source, int32 SourceSlot, UInventory* Destination, int32 DestinationSlot);
+
+    // Moves several slots at once (auto-placed like above) with a single refresh per inventory
+    // Returns for every source slot the destination slot written last, or INDEX_NONE when it didn't move
+    static TArray<int32> TransferItems(UInventory* Source, TConstArrayView<int32> SourceSlots, UInventory* Destination);
+
+    // ************* Command queue (loot generation, quest rewards, server validation...) *************
+
+    // Queues a mutation from any thread (lock free, any number of producers)
+    // On a replicated client queued moves are sent to the server, anything else is dropped
+    // The game thread applies every queued command once per frame with a single refresh, from the core ticker so a
+    // collapsed or offscreen inventory keeps draining. Commands queued during a drag wait until it's released,
+    // a transfer into an inventory that is mid drag waits for that one and holds back every command queued after it
+    // (commands always apply in the order they were queued)
+    void EnqueueCommand(FInventoryCommand&& Command);
+
+    // Game thread only, applies every queued command right away and returns how many changed something
+    // (commands that no longer make sense are dropped, deferred ones stay queued, neither is counted)
+    int32 FlushCommands();
+
+    // Returns how many commands the last flush applied (dropped and deferred ones aren't counted)
+    int32 GetLastFlushCommandCount() const;
+
+    // **************************************************************************
+
+    // Returns the array of slot widgets currently in view (bound to items starting at GetFirstVisibleRow())
+    // Empty in leaf renderer mode, where a single widget paints every slot
     TArray<TObjectPtr<UBorder>> GetSlots() const;
 
+    // Returns the first item row bound to slot widgets
+    int32 GetFirstVisibleRow() const;
+
+    // Scrolls the grid to a pixel offset, rebinding slot widgets to other items when crossing rows
+    void SetScrollOffset(float NewScrollOffset);
+
     // Returns the grid widget containing all slot data
     TObjectPtr<UUniformGridPanel> GetGrid() const;
 
+    // Returns how many slots the last RefreshInventory() call rebuilt
+    int32 GetLastRefreshRebuiltSlotCount() const;
+
+    // Returns how many allocations inventory code made during the last drag, press to release
+    // (widgets, label texts and asset load requests, a warmed up drag makes none; engine internals aren't counted)
+    int32 GetLastDragAllocationCount() const;
+
+    // Returns the total time the game thread spent blocked on synchronous item asset loads
+    double GetBlockedLoadSeconds() const;
+
+    // Returns hit rate and spawn/destroy counts of the pickup/drop actor pool
+    const FInventoryActorPoolStats& GetActorPoolStats() const;
+
+    // Returns how long the last LoadSnapshot() call took, file mapping included
+    double GetLastSnapshotLoadSeconds() const;
+
+    // Returns how many mouse move events arrived during the last frame (at most one drag update processes them)
+    int32 GetLastFrameMouseMoveEvents() const;
+
+    // Returns every mouse move event received while pressing or dragging, compare with GetTotalDragUpdates()
+    int64 GetTotalMouseMoveEvents() const;
+
+    // Returns how many per-frame drag updates actually processed mouse movement
+    int64 GetTotalDragUpdates() const;
+
+    // Every counter above by name, in a stable order (used by the Inventory.PerfReport console command)
+    TArray<TPair<FString, double>> GetPerfCounters() const;
+
+    // Server: every slot change gets pushed to the component as a delta. Client: slots come from the component,
+    // local mutations are refused and drag moves are sent to the server instead
+    void BindReplication(UInventoryReplicationComponent* Component);
+
+    // Client side of replication, interns an archetype received from the server and returns its local handle
+    int32 InternReplicatedArchetype(const FInventoryArchetype& Archetype);
+
+    // Client side of replication, writes the received slots and refreshes once
+    void ApplyReplicatedSlots(const TMap<int32, FInventorySlotEntry>& ChangedSlots);
+
+    // Maximum number of picked up actors kept hidden for reuse by drops
+    UPROPERTY(EditAnywhere, Category = "Inventory")
+    int32 ActorPoolBudget;
+
 private:
 
+    // Automation tests reach the renderer mode and full refreshes through this (see InventoryTestHarness.h)
+    friend struct FInventoryTestAccess;
+
     // ************* Max rows and columns for determening grid size *************
-    UPROPERTY()
+    UPROPERTY(EditAnywhere, Category = "Inventory")
     uint32 MaxRows;
 
-    UPROPERTY()
+    UPROPERTY(EditAnywhere, Category = "Inventory")
     uint32 MaxColumns;
 
+    // Rows visible at once, more rows than this make the grid scroll
+    UPROPERTY(EditAnywhere, Category = "Inventory")
+    uint32 VisibleRows;
+
+    // Extra rows of slot widgets beyond the visible ones so partially scrolled rows are covered
+    UPROPERTY(EditAnywhere, Category = "Inventory")
+    uint32 OverscanRows;
+
+    // Scroll speed while dragging an item close to the top or bottom edge of the grid
+    UPROPERTY(EditAnywhere, Category = "Inventory")
+    float AutoScrollSpeed;
+
+    // How many identical items (same class, mesh and materials) a single slot can hold
+    UPROPERTY(EditAnywhere, Category = "Inventory", meta = (ClampMin = "1"))
+    int32 MaxStackSize;
+
+    // One leaf widget paints every slot background, icon and label instead of five widgets per slot
+    // (read when the widget gets initialized, meant for large grids and split-screen)
+    UPROPERTY(EditAnywhere, Category = "Inventory")
+    bool bUseLeafGridRenderer;
+
     // **************************************************************************
 
+    // Rows of slot widgets actually built (never depends on the inventory size beyond VisibleRows + OverscanRows)
+    int32 NumWidgetRows;
+
+    // Pixel scroll offset of the grid, item row FirstVisibleRow sits in the first widget row
+    float ScrollOffset;
+
+    int32 FirstVisibleRow;
+
+    // ************* Item storage (structure of arrays, one entry per slot) *************
+
+    // Class, mesh and materials shared by identical items
     UPROPERTY()
-    TArray<FItem> Items;
+    FInventoryArchetypeTable ArchetypeTable;
+
+    // Archetype handle of every slot, INDEX_NONE when the slot is empty
+    TArray<int32> SlotArchetypes;
+
+    // Unique item index of every slot
+    TArray<int32> SlotItemIds;
+
+    // World transform every item had when it got picked up
+    TArray<FTransform> SlotTransforms;
+
+    // Number of identical items stacked in every slot, 0 when the slot is empty
+    TArray<int32> SlotQuantities;
+
+    // For every archetype handle the slots holding a stack of it that still has room
+    TArray<TArray<int32>> OpenStacksByArchetype;
+
+    // For every archetype handle every slot holding it, and how many items those slots hold in total
+    TArray<TArray<int32>> SlotsByArchetype;
+
+    TArray<int32> QuantityByArchetype;
+
+    // Where every slot sits in its archetype's SlotsByArchetype list, so unlinking it is O(1)
+    TArray<int32> SlotPositionsInArchetype;
+
+    // Delta replication of the slots above, when bound
+    TWeakObjectPtr<UInventoryReplicationComponent> ReplicationComponent;
+
+    // FItem view of the slots handed out by GetItems()
+    mutable TArray<FItem> ItemsView;
+
+    mutable bool bIsItemsViewStale;
+
+    // **************************************************************************
 
     UPROPERTY()
     TArray<TObjectPtr<UBorder>> Slots;
 
+    // Unique item indices, released ones get reused smallest first
+    FInventoryIdAllocator ItemIdAllocator;
+
+    // One bit per slot, set while the slot holds an item (kept in sync by OnSlotChanged())
+    FInventorySlotBitmap OccupiedSlots;
+
+    // One bit per slot, set whenever the slot's item changed since the last refresh
+    TBitArray<> DirtySlots;
+
+    // Number of slots rebuilt by the last refresh (a drag swap should rebuild exactly two)
+    int32 LastRefreshRebuiltSlotCount;
+
+    // ************* Cached slot rects for hover hit-testing (structure of arrays) *************
+
+    // Absolute slot bounds, padded with never-hit entries up to a multiple of 4 for vectorised scans
+    TArray<float> SlotRectMinX;
+    TArray<float> SlotRectMinY;
+    TArray<float> SlotRectMaxX;
+    TArray<float> SlotRectMaxY;
+
+    // Absolute grid geometry the rect table was built from (table is rebuilt when it changes)
+    FVector2D SlotRectGridPosition;
+    FVector2D SlotRectGridSize;
+
+    bool bIsSlotRectTableValid;
+
+    // When every slot sits on a regular lattice hover lookup is pure arithmetic
+    bool bAreSlotRectsUniform;
+    FVector2D SlotLatticeOrigin;
+    FVector2D SlotLatticePitch;
+    FVector2D SlotLatticeSize;
+
+    // *****************************************************************************************
+
+    // Persistent icon widgets of every slot widget (same indexing as Slots)
+    UPROPERTY()
+    TArray<FItemIconWidgets> SlotIcons;
+
+    // Total UObjects allocated by this widget through NewTrackedWidget()
+    int32 WidgetAllocationCount;
+
+    // Every allocation made by inventory code: widgets above, label texts built and asset load requests
+    int32 TrackedAllocationCount;
+
+    // TrackedAllocationCount at the moment the current drag was pressed
+    int32 DragStartAllocationCount;
+
+    // Allocations made between press and release of the last drag
+    int32 LastDragAllocationCount;
+
+    // Slot label of every live item index and the quantity it was formatted for, so moving an item never formats
+    // a new text (entries go with their index, see ReleaseItemId())
+    TMap<int32, TPair<int32, FText>> ItemLabels;
+
     UPROPERTY()
     TObjectPtr<UCanvasPanel> Canvas;
 
@@ -103,6 +423,10 @@ private:
     UPROPERTY()
     TObjectPtr<UBorder> Background;
 
+    // Caches everything under the background so an idle inventory neither lays out nor paints its children again
+    UPROPERTY()
+    TObjectPtr<UInvalidationBox> BackgroundInvalidationBox;
+
     UPROPERTY()
     TObjectPtr<UCanvasPanelSlot> BackgroundSlot;
 
@@ -116,6 +440,14 @@ private:
     UPROPERTY()
     TObjectPtr<UVerticalBoxSlot> TitleVerticalBoxSlot;
 
+    // Fixed height box clipping the scrollable grid to VisibleRows
+    UPROPERTY()
+    TObjectPtr<USizeBox> GridViewport;
+
+    // Scrolls the grid by less than a row, whole rows are handled by rebinding slot widgets
+    UPROPERTY()
+    TObjectPtr<UScrollBox> GridScrollBox;
+
     // Grid of the inventory slots
     UPROPERTY()
     TObjectPtr<UUniformGridPanel> Grid;
@@ -126,9 +458,13 @@ private:
     UPROPERTY()
     TObjectPtr<UUniformGridSlot> GridSlot;
 
-    // Visual Representation of PoppedOutItem
+    // Leaf renderer mode only, takes the uniform grid's place in the scroll box
+    UPROPERTY()
+    TObjectPtr<UInventoryGridWidget> LeafGrid;
+
+    // Visual Representation of PoppedOutItem, one persistent ghost hidden while nothing is dragged
     UPROPERTY()
-    TObjectPtr<UOverlay> PoppedOutItemWidget;
+    FItemIconWidgets PoppedOutItemWidget;
 
     // Index of the currently hovered slot
     UPROPERTY()
@@ -139,8 +475,20 @@ private:
     int32 OriginSlotIndex;
 
     // PoppedOutItem used to copy internal item when item outside inventoty 
-    UPROPERTY()
-    FItem PoppedOutItem;
+    FInventorySlotEntry PoppedOutItem;
+
+    // Async prefetch of PoppedOutItem's mesh and materials, started as soon as a drag is pressed
+    TSharedPtr<FStreamableHandle> PoppedOutItemAssetsHandle;
+
+    // Loads still in flight for items dropped to the world as placeholders
+    TArray<TSharedPtr<FStreamableHandle>> InFlightDropLoads;
+
+    // Time spent blocked on synchronous item asset loads
+    double BlockedLoadSeconds;
+
+    double LastSnapshotLoadSeconds;
+
+    int32 LastSortMoveCount;
 
     // Mouse position in screen space
     UPROPERTY()
@@ -150,6 +498,42 @@ private:
     UPROPERTY()
     FVector2D MouseWidgetLocalPosition;
 
+    // Mouse position in screen space when the item got pressed
+    FVector2D PressScreenSpacePosition;
+
+    // Shift was held on press, half of the pressed stack gets split off when the drag starts
+    bool bSplitOnDragStart;
+
+    // ************* Mouse move coalescing (events only record the cursor, NativeTick processes them) *************
+
+    int32 PendingMouseMoveEvents;
+
+    int32 LastFrameMouseMoveEvents;
+
+    int64 TotalMouseMoveEvents;
+
+    int64 TotalDragUpdates;
+
+    // **************************************************************************
+
+    // Mutations queued from any thread, drained by the game thread
+    TQueue<FInventoryCommand, EQueueMode::Mpsc> PendingCommands;
+
+    // Game thread only, a deferred command and everything dequeued behind it, in queue order
+    // Drained before PendingCommands so nothing overtakes a command that had to wait
+    TArray<FInventoryCommand> HeldCommands;
+
+    int32 LastFlushCommandCount;
+
+    // Drains PendingCommands once per frame, registered for the widget's whole lifetime
+    FTSTicker::FDelegateHandle CommandFlushTickerHandle;
+
+    // Picked up actors kept inactive for reuse by drops of the same class and mesh
+    FInventoryActorPool ActorPool;
+
+    // Picked up actors waiting to be destroyed as one batch on the next tick
+    TArray<TWeakObjectPtr<AActor>> PendingDestroyActors;
+
     // Current drag state
     EDragState DragState;
 
@@ -162,23 +546,197 @@ private:
     UFUNCTION()
     void Create();
 
-    // Updates all slot visuals based on current item data
+    // Updates the visuals of every dirty slot based on current item data
     UFUNCTION()
     void RefreshInventory();
 
-    // Creates or updates the icon for a single item slot
+    // Flags a single slot to be rebuilt on the next refresh
+    void MarkSlotDirty(int32 SlotIndex);
+
+    // Whether slots only change through replication (bound to a component without authority)
+    bool IsReplicatedClient() const;
+
+    // Logs and returns true on a replicated client, whose slot changes have to come from the server
+    bool RejectClientMutation(const TCHAR* Operation) const;
+
+    // Called by every slot write to keep slot bookkeeping up to date
+    void OnSlotChanged(int32 SlotIndex);
+
+    // ******************** Slot storage access (every slot mutation goes through these) ********************
+
+    int32 NumSlots() const;
+
+    bool IsValidSlot(int32 SlotIndex) const;
+
+    bool IsSlotOccupied(int32 SlotIndex) const;
+
+    // Resizes the slot storage, emptying every slot
+    void ResetSlots(int32 NewNumSlots);
+
+    FInventorySlotEntry ReadSlot(int32 SlotIndex) const;
+
+    void WriteSlot(int32 SlotIndex, const FInventorySlotEntry& Entry);
+
+    void ClearSlot(int32 SlotIndex);
+
+    // Exchanges two slots' contents (a handful of integer copies plus the transforms)
+    void SwapSlots(int32 FirstSlotIndex, int32 SecondSlotIndex);
+
+    // Builds the FItem an archetype and per-instance data describe
+    FItem MakeItem(const FInventorySlotEntry& Entry) const;
+
+    // ******************** Stacks ********************
+
+    // Keeps the per-archetype indices (open stacks, slots and quantities) in sync, called around every slot write
+    void LinkSlot(int32 SlotIndex);
+
+    void UnlinkSlot(int32 SlotIndex);
+
+    void IndexSlot(int32 SlotIndex);
+
+    void UnindexSlot(int32 SlotIndex);
+
+    // Keeps OpenStacksByArchetype in sync
+    void TrackOpenStack(int32 SlotIndex);
+
+    void UntrackOpenStack(int32 SlotIndex);
+
+    // Returns a slot holding a non-full stack of the archetype, INDEX_NONE when there's none
+    int32 FindOpenStack(int32 ArchetypeHandle) const;
+
+    // Moves half of a stack into the first empty slot, returns that slot or INDEX_NONE when it couldn't split
+    int32 SplitStack(int32 SlotIndex);
+
+    // Checks whether the source stack can be (at least partially) merged onto the target stack
+    bool CanMergeStacks(int32 SourceSlotIndex, int32 TargetSlotIndex) const;
+
+    // Moves as many items as fit from the source stack onto the target, emptying the source when all of them fit
+    void MergeStacks(int32 SourceSlotIndex, int32 TargetSlotIndex);
+
+    // ******************** Transfers ********************
+
+    // Returns this inventory's handle for a source inventory archetype, ArchetypeRemap caches it by source handle
+    // (the archetype, materials included, only gets copied when it's new to this inventory)
+    int32 ImportArchetype(const UInventory& Source, int32 SourceHandle, TArray<int32>& ArchetypeRemap);
+
+    // Same lookup without copying anything, INDEX_NONE when the archetype is new to this inventory
+    int32 FindImportedArchetype(const UInventory& Source, int32 SourceHandle, TArray<int32>& ArchetypeRemap) const;
+
+    // Transfer without drag checks or refreshing, shared by TransferItem(), TransferItems() and cross-inventory drops
+    // Stacks are kept within the receiving inventory's MaxStackSize, what doesn't fit stays in the source slot
+    // Refused (with a warning) when either inventory is a replicated client
+    static int32 MoveSlotBetween(UInventory& Source, int32 SourceSlot, UInventory& Destination, int32 DestinationSlot, TArray<int32>& ArchetypeRemap);
+
+    // Returns another live and visible inventory whose body is under an absolute position, nullptr when there's none
+    UInventory* FindInventoryAt(const FVector2D& AbsolutePosition) const;
+
+    // ************************************************
+
+    // ********************************************************************************************************
+
+    // Flags every slot to be rebuilt on the next refresh
+    void MarkAllSlotsDirty();
+
+    // Number of slot widgets (or leaf grid cells) in view, VisibleRows + OverscanRows rows at most
+    int32 NumWidgetSlots() const;
+
+    // Returns the slot widget an item slot is bound to, INDEX_NONE when scrolled out of view
+    int32 ItemSlotToWidgetSlot(int32 ItemSlotIndex) const;
+
+    // Returns the item slot a slot widget is currently bound to
+    int32 WidgetSlotToItemSlot(int32 WidgetSlotIndex) const;
+
+    // Updates the persistent icon for a single item slot
     UFUNCTION()
     void CreateItemIcon(uint32 SlotIndex);
 
+    // Builds an overlay holding an icon image and an index text
+    FItemIconWidgets BuildItemIconWidgets();
+
+    // Builds the persistent drag ghost on the canvas
+    void BuildGhostWidget();
+
+    // Returns the cached label of an item index and quantity, only formatted the first time it's shown
+    const FText& GetItemLabel(int32 ItemId, int32 Quantity);
+
+    // Frees a unique item index along with its cached label
+    void ReleaseItemId(int32 ItemId);
+
+    // Sets a label text block's text unless it already shows exactly that text
+    static void SetLabelText(UTextBlock* LabelText, const FText& Label);
+
+    // NewObject wrapper counting every widget this inventory allocates
+    template<typename WidgetType>
+    WidgetType* NewTrackedWidget()
+    {
+        ++WidgetAllocationCount;
+        ++TrackedAllocationCount;
+        INVENTORY_INC_COUNTER(STAT_InventoryWidgetsCreated);
+        return NewObject<WidgetType>(this);
+    }
+
     // Finds the first empty inventory slot index
     UFUNCTION()
     int32 FindFirstEmptySlot() const;
 
-    // Resposible for updating all items position on drag
+    // Starts streaming PoppedOutItem's mesh and materials in the background
+    void PrefetchPoppedOutItemAssets();
+
+    // Spawns PoppedOutItem in the world without blocking on its assets
+    void SpawnPoppedOutItem(UWorld* World);
+
+    // Applies an archetype's mesh and materials to a mesh component (only the ones already in memory)
+    static void ApplyItemAssets(UStaticMeshComponent* MeshComponent, const FInventoryArchetype& Archetype);
+
+    // Stores an actor as an item in the first empty slot without refreshing, returns the slot or INDEX_NONE
+    int32 PlaceItem(AActor* ItemActor);
+
+    // Stores one item of an interned archetype onto an open stack or into the first empty slot, without refreshing
+    int32 PlaceArchetype(int32 ArchetypeHandle, const FTransform& Transform);
+
+    // Core ticker callback draining the command queue
+    bool TickCommandQueue(float DeltaTime);
+
+    // Applies a single queued command without refreshing, inventories it touched besides this one get added
+    EInventoryCommandResult ApplyCommand(const FInventoryCommand& Command, TArray<UInventory*, TInlineAllocator<4>>& OutTouchedInventories);
+
+    // Hands an added actor to the actor pool, or gets rid of it when the pool is over budget
+    void RetireActor(AActor* ItemActor, const FSoftObjectPath& MeshPath, bool bDeferDestroy);
+
+    // Hides an added actor right away and queues it for the batched destroy
+    void QueueActorDestroy(AActor* ItemActor);
+
+    // Destroys every actor queued by QueueActorDestroy()
+    void DestroyPendingActors();
+
+    // Records a structured event in the trace ring buffer (no formatting, nothing in shipping builds)
+    void TraceEvent(EInventoryTraceEventType Type, int32 SlotIndex, int32 OtherSlotIndex, int32 ItemId) const;
+
+    // Per-frame drag work: drag threshold, ghost movement, auto-scroll, hover resolution and rearranging
+    void UpdateDrag(const FGeometry& MyGeometry, float DeltaTime, bool bHasMouseMoved);
+
+    // Scrolls while the cursor is held near the top or bottom edge of the grid, returns whether it scrolled
+    bool UpdateAutoScroll(float DeltaTime);
+
+    void UpdateMouseInsideInventory();
+
+    // Resposible for updating all items position on drag (HoveredSlotIndex must already be resolved)
     UFUNCTION()
-    void InternallyRearrangeItems(const FPointerEvent& MouseEvent);
+    void InternallyRearrangeItems();
 
-    // Returns the index of the hovered slot under the mouse
+    // Returns the index of the hovered item slot under the mouse
     UFUNCTION()
     int32 FindHoveredSlot(const FPointerEvent& InMouseEvent);
+
+    // Returns the index of the item slot under an absolute position
+    int32 FindHoveredSlotAt(const FVector2D& AbsolutePosition);
+
+    // Re-reads every slot's cached geometry into the slot rect table
+    void RebuildSlotRectTable();
+
+    // Whether the grid moved or resized since the slot rect table was built
+    bool IsSlotRectTableStale() const;
+
+    // Returns the slot widget containing an absolute position using the slot rect table
+    int32 FindSlotAtPosition(const FVector2D& AbsolutePosition) const;
 };
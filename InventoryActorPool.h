@@ -0,0 +1,163 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "UObject/ObjectKey.h"
+#include "InventoryStats.h"
+
+// Counters describing how well the actor pool is doing
+struct FInventoryActorPoolStats
+{
+    // Drops that reused a pooled actor
+    int32 HitCount = 0;
+
+    // Drops that found no pooled actor for their class and mesh
+    int32 MissCount = 0;
+
+    // Actors spawned because of a miss
+    int32 SpawnCount = 0;
+
+    // Actors destroyed because the pool was over budget
+    int32 DestroyCount = 0;
+
+    float GetHitRate() const
+    {
+        const int32 RequestCount = HitCount + MissCount;
+        return RequestCount > 0 ? float(HitCount) / float(RequestCount) : 0.0f;
+    }
+};
+
+// Pooled actors are only interchangeable when both their class and their mesh match
+struct FInventoryActorPoolKey
+{
+    FObjectKey ActorClass;
+
+    FSoftObjectPath MeshPath;
+
+    bool operator==(const FInventoryActorPoolKey& Other) const
+    {
+        return ActorClass == Other.ActorClass && MeshPath == Other.MeshPath;
+    }
+
+    friend uint32 GetTypeHash(const FInventoryActorPoolKey& Key)
+    {
+        return HashCombine(GetTypeHash(Key.ActorClass), GetTypeHash(Key.MeshPath));
+    }
+};
+
+// Picked up world actors kept hidden and inactive, keyed by actor class and static mesh, so drops can reuse them
+struct FInventoryActorPool
+{
+public:
+    // Maximum number of actors kept in the pool across all keys
+    void SetBudget(int32 InBudget)
+    {
+        Budget = FMath::Max(InBudget, 0);
+    }
+
+    // Deactivates an actor and keeps it for a later drop of the same class and mesh
+    // Returns false when the pool is over budget, the caller then has to destroy the actor itself
+    bool Release(AActor* Actor, const FSoftObjectPath& MeshPath)
+    {
+        if (!Actor)
+            return false;
+
+        // Pooled actors destroyed behind our back still count against the budget until purged
+        if (NumPooledActors >= Budget)
+            PurgeInvalidActors();
+
+        if (NumPooledActors >= Budget)
+            return false;
+
+        Actor->SetActorHiddenInGame(true);
+        Actor->SetActorEnableCollision(false);
+        Actor->SetActorTickEnabled(false);
+
+        FreeActors.FindOrAdd(FInventoryActorPoolKey{ Actor->GetClass(), MeshPath }).Add(Actor);
+        ++NumPooledActors;
+        return true;
+    }
+
+    // Returns a reactivated pooled actor of exactly this class with the given mesh, or nullptr on a miss
+    AActor* Acquire(const UClass* ActorClass, const FSoftObjectPath& MeshPath, const FTransform& Transform)
+    {
+        if (TArray<TWeakObjectPtr<AActor>>* MeshActors = FreeActors.Find(FInventoryActorPoolKey{ ActorClass, MeshPath }))
+        {
+            while (MeshActors->Num() > 0)
+            {
+                AActor* Actor = MeshActors->Pop(EAllowShrinking::No).Get();
+                --NumPooledActors;
+
+                // Something else may have destroyed a pooled actor (level unload for instance)
+                if (!IsValid(Actor))
+                    continue;
+
+                Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+                Actor->SetActorHiddenInGame(false);
+                Actor->SetActorEnableCollision(true);
+                Actor->SetActorTickEnabled(true);
+
+                ++Stats.HitCount;
+                return Actor;
+            }
+        }
+
+        ++Stats.MissCount;
+        return nullptr;
+    }
+
+    // Destroys every pooled actor
+    void Empty()
+    {
+        for (TPair<FInventoryActorPoolKey, TArray<TWeakObjectPtr<AActor>>>& MeshActors : FreeActors)
+        {
+            for (const TWeakObjectPtr<AActor>& PooledActor : MeshActors.Value)
+            {
+                if (AActor* Actor = PooledActor.Get())
+                    Actor->Destroy();
+            }
+        }
+
+        FreeActors.Empty();
+        NumPooledActors = 0;
+    }
+
+    void NotifyActorSpawned()
+    {
+        ++Stats.SpawnCount;
+        INVENTORY_INC_COUNTER(STAT_InventoryActorsSpawned);
+    }
+
+    void NotifyActorDestroyed()
+    {
+        ++Stats.DestroyCount;
+        INVENTORY_INC_COUNTER(STAT_InventoryActorsDestroyed);
+    }
+
+    const FInventoryActorPoolStats& GetStats() const { return Stats; }
+
+private:
+    // Drops every pooled actor something else destroyed and recounts the pool
+    void PurgeInvalidActors()
+    {
+        NumPooledActors = 0;
+
+        for (auto It = FreeActors.CreateIterator(); It; ++It)
+        {
+            It.Value().RemoveAllSwap([](const TWeakObjectPtr<AActor>& PooledActor) { return !IsValid(PooledActor.Get()); }, EAllowShrinking::No);
+
+            if (It.Value().Num() == 0)
+                It.RemoveCurrent();
+            else
+                NumPooledActors += It.Value().Num();
+        }
+    }
+
+    TMap<FInventoryActorPoolKey, TArray<TWeakObjectPtr<AActor>>> FreeActors;
+
+    int32 NumPooledActors = 0;
+
+    int32 Budget = 0;
+
+    FInventoryActorPoolStats Stats;
+};
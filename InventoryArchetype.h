@@ -0,0 +1,147 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Item.h"
+#include "UObject/ObjectKey.h"
+#include "InventoryArchetype.generated.h"
+
+// Everything two identical items have in common (class, mesh and materials)
+// Stored once in the archetype table no matter how many slots hold such an item
+USTRUCT()
+struct FInventoryArchetype
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TSubclassOf<AActor> WorldObjectReference;
+
+    UPROPERTY()
+    TSoftObjectPtr<UStaticMesh> StaticMesh;
+
+    UPROPERTY()
+    TArray<TSoftObjectPtr<UMaterialInterface>> StoredMaterials;
+
+    bool operator==(const FInventoryArchetype& Other) const
+    {
+        return WorldObjectReference == Other.WorldObjectReference && StaticMesh == Other.StaticMesh && StoredMaterials == Other.StoredMaterials;
+    }
+
+    friend uint32 GetTypeHash(const FInventoryArchetype& Archetype)
+    {
+        uint32 Hash = HashCombine(GetTypeHash(Archetype.WorldObjectReference.Get()), GetTypeHash(Archetype.StaticMesh));
+        for (const TSoftObjectPtr<UMaterialInterface>& Material : Archetype.StoredMaterials)
+            Hash = HashCombine(Hash, GetTypeHash(Material));
+
+        return Hash;
+    }
+};
+
+// One slot's worth of item data: a handle into the archetype table plus the per-instance data
+struct FInventorySlotEntry
+{
+    // Handle into the archetype table, INDEX_NONE for an empty slot
+    int32 Archetype = INDEX_NONE;
+
+    // Unique item index
+    int32 ItemId = INDEX_NONE;
+
+    // Number of identical items stacked in the slot
+    int32 Quantity = 0;
+
+    // Where the item was in the world when it got picked up
+    FTransform Transform = FTransform::Identity;
+
+    bool IsEmpty() const { return Archetype == INDEX_NONE; }
+};
+
+// Interns archetypes so every distinct (class, mesh, material-set) combination is stored once and referenced by handle
+// Archetypes are never removed, the table only grows with the number of distinct item kinds ever held
+USTRUCT()
+struct FInventoryArchetypeTable
+{
+    GENERATED_BODY()
+
+public:
+    // Returns the handle of an identical archetype, INDEX_NONE when the table doesn't hold one (never adds)
+    int32 Find(const FInventoryArchetype& Archetype) const
+    {
+        return FindByHash(Archetype, GetTypeHash(Archetype));
+    }
+
+    // Returns the handle of an identical archetype, adding it to the table when it's new
+    int32 Intern(const FInventoryArchetype& Archetype)
+    {
+        const uint32 Hash = GetTypeHash(Archetype);
+
+        const int32 ExistingHandle = FindByHash(Archetype, Hash);
+        if (ExistingHandle != INDEX_NONE)
+            return ExistingHandle;
+
+        const int32 Handle = Archetypes.Add(Archetype);
+        HandlesByHash.Add(Hash, Handle);
+        HandlesByClass.FindOrAdd(FObjectKey(Archetype.WorldObjectReference.Get())).Add(Handle);
+        HandlesByMesh.FindOrAdd(Archetype.StaticMesh.ToSoftObjectPath()).Add(Handle);
+        return Handle;
+    }
+
+    const FInventoryArchetype& Get(int32 Handle) const
+    {
+        check(IsValidHandle(Handle));
+        return Archetypes[Handle];
+    }
+
+    // Handles of every archetype with exactly this class
+    TConstArrayView<int32> GetHandlesByClass(const UClass* Class) const
+    {
+        const TArray<int32>* Handles = HandlesByClass.Find(FObjectKey(Class));
+        return Handles ? TConstArrayView<int32>(*Handles) : TConstArrayView<int32>();
+    }
+
+    // Handles of every archetype with this mesh
+    TConstArrayView<int32> GetHandlesByMesh(const FSoftObjectPath& MeshPath) const
+    {
+        const TArray<int32>* Handles = HandlesByMesh.Find(MeshPath);
+        return Handles ? TConstArrayView<int32>(*Handles) : TConstArrayView<int32>();
+    }
+
+    bool IsValidHandle(int32 Handle) const
+    {
+        return Archetypes.IsValidIndex(Handle);
+    }
+
+    int32 Num() const
+    {
+        return Archetypes.Num();
+    }
+
+    void Reset()
+    {
+        Archetypes.Reset();
+        HandlesByHash.Reset();
+        HandlesByClass.Reset();
+        HandlesByMesh.Reset();
+    }
+
+private:
+    int32 FindByHash(const FInventoryArchetype& Archetype, uint32 Hash) const
+    {
+        // Hash collisions are possible, so compare every archetype sharing the hash
+        for (auto It = HandlesByHash.CreateConstKeyIterator(Hash); It; ++It)
+        {
+            if (Archetypes[It.Value()] == Archetype)
+                return It.Value();
+        }
+
+        return INDEX_NONE;
+    }
+
+    UPROPERTY()
+    TArray<FInventoryArchetype> Archetypes;
+
+    TMultiMap<uint32, int32> HandlesByHash;
+
+    // Secondary indices, not seen by GC. FObjectKey hashes a class stably without the index holding a strong reference
+    TMap<FObjectKey, TArray<int32>> HandlesByClass;
+
+    TMap<FSoftObjectPath, TArray<int32>> HandlesByMesh;
+};
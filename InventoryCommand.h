@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryArchetype.h"
+
+class UInventory;
+
+// Kinds of queued inventory mutations
+enum class EInventoryCommandType : uint8
+{
+    None,
+    Add,      // Quantity items of Archetype, auto-placed onto open stacks first
+    Remove,   // Whole stack held in Slot
+    Move,     // Slot onto OtherSlot of the same inventory (merge or swap, like a drag)
+    Transfer, // Slot onto OtherSlot of TargetInventory (INDEX_NONE auto-places)
+};
+
+// What applying a queued command did
+enum class EInventoryCommandResult : uint8
+{
+    Applied,  // At least one slot changed
+    Dropped,  // Nothing to do anymore (empty or invalid slot, missing target, full inventory, refused on a client)
+    Deferred, // Can't run yet (transfer into a dragging inventory), it and every command behind it wait for a later flush
+};
+
+// One inventory mutation, plain data so it can be built on any thread without touching a live actor or widget
+struct FInventoryCommand
+{
+    EInventoryCommandType Type = EInventoryCommandType::None;
+
+    // Add: the item kind by class, mesh and materials
+    FInventoryArchetype Archetype;
+
+    // Add: world transform the items are dropped back at
+    FTransform Transform = FTransform::Identity;
+
+    int32 Quantity = 0;
+
+    int32 Slot = INDEX_NONE;
+
+    int32 OtherSlot = INDEX_NONE;
+
+    // Transfer: inventory receiving the item
+    TWeakObjectPtr<UInventory> TargetInventory;
+
+    static FInventoryCommand MakeAdd(FInventoryArchetype InArchetype, int32 InQuantity = 1, const FTransform& InTransform = FTransform::Identity)
+    {
+        FInventoryCommand Command;
+        Command.Type = EInventoryCommandType::Add;
+        Command.Archetype = MoveTemp(InArchetype);
+        Command.Transform = InTransform;
+        Command.Quantity = InQuantity;
+        return Command;
+    }
+
+    static FInventoryCommand MakeRemove(int32 InSlot)
+    {
+        FInventoryCommand Command;
+        Command.Type = EInventoryCommandType::Remove;
+        Command.Slot = InSlot;
+        return Command;
+    }
+
+    static FInventoryCommand MakeMove(int32 InSlot, int32 InOtherSlot)
+    {
+        FInventoryCommand Command;
+        Command.Type = EInventoryCommandType::Move;
+        Command.Slot = InSlot;
+        Command.OtherSlot = InOtherSlot;
+        return Command;
+    }
+
+    static FInventoryCommand MakeTransfer(int32 InSlot, UInventory* InTargetInventory, int32 InOtherSlot = INDEX_NONE)
+    {
+        FInventoryCommand Command;
+        Command.Type = EInventoryCommandType::Transfer;
+        Command.Slot = InSlot;
+        Command.OtherSlot = InOtherSlot;
+        Command.TargetInventory = InTargetInventory;
+        return Command;
+    }
+};
@@ -0,0 +1,72 @@
+#include "InventoryTestHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    FInventoryArchetype MakeCommandArchetype(const TCHAR* MeshPath)
+    {
+        FInventoryArchetype Archetype;
+        Archetype.WorldObjectReference = AStaticMeshActor::StaticClass();
+        Archetype.StaticMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(MeshPath));
+        return Archetype;
+    }
+}
+
+// Only commands that changed something are counted, and a transfer waiting on a dragging inventory holds back
+// every command queued after it, so later commands on the same slots can't overtake it
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryCommandOrderTest, "Inventory.Commands.Order", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInventoryCommandOrderTest::RunTest(const FString& Parameters)
+{
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+    Fixture.SetGridSize(3, 4);
+    UInventory& Chest = Fixture.AddOtherInventory(3, 4);
+
+    const FInventoryArchetype Cube = MakeCommandArchetype(TEXT("/Engine/BasicShapes/Cube.Cube"));
+    const FInventoryArchetype Sphere = MakeCommandArchetype(TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+
+    // Two adds change something, removing and moving empty slots doesn't
+    Inventory.EnqueueCommand(FInventoryCommand::MakeAdd(Cube, 3));
+    Inventory.EnqueueCommand(FInventoryCommand::MakeAdd(Sphere, 1));
+    Inventory.EnqueueCommand(FInventoryCommand::MakeRemove(5));
+    Inventory.EnqueueCommand(FInventoryCommand::MakeMove(7, 8));
+
+    TestEqual(TEXT("Only applied commands are counted"), Inventory.FlushCommands(), 2);
+    TestEqual(TEXT("Cube stack"), Inventory.GetItemQuantity(0), 3);
+    TestEqual(TEXT("Sphere stack"), Inventory.GetItemQuantity(1), 1);
+    TestEqual(TEXT("Occupied slots"), Inventory.GetNumOccupiedSlots(), 2);
+
+    // The transfer has to wait for the chest's drag, the remove and move queued behind it touch the slot it moves
+    FInventoryTestAccess::SetDragging(Chest, true);
+
+    Inventory.EnqueueCommand(FInventoryCommand::MakeTransfer(0, &Chest, 0));
+    Inventory.EnqueueCommand(FInventoryCommand::MakeRemove(0));
+    Inventory.EnqueueCommand(FInventoryCommand::MakeMove(1, 0));
+
+    TestEqual(TEXT("Nothing applied while the chest is dragging"), Inventory.FlushCommands(), 0);
+    TestEqual(TEXT("Cube stays behind the deferred transfer"), Inventory.GetItemQuantity(0), 3);
+    TestEqual(TEXT("Sphere stays behind the deferred transfer"), Inventory.GetItemQuantity(1), 1);
+
+    // Queued while commands are held, it has to wait behind them too
+    Inventory.EnqueueCommand(FInventoryCommand::MakeAdd(Sphere, 1));
+    TestEqual(TEXT("Still nothing applied on a second flush"), Inventory.FlushCommands(), 0);
+    TestEqual(TEXT("Late add waits behind the held commands"), Inventory.GetNumOccupiedSlots(), 2);
+
+    FInventoryTestAccess::SetDragging(Chest, false);
+
+    // Transfer, then the remove finds slot 0 empty (dropped), the sphere moves to slot 0 and the late add stacks on it
+    TestEqual(TEXT("Held commands applied in order"), Inventory.FlushCommands(), 3);
+    TestEqual(TEXT("Cube stack transferred whole"), Chest.GetItemQuantity(0), 3);
+    TestEqual(TEXT("Sphere moved into slot 0 and stacked"), Inventory.GetItemQuantity(0), 2);
+    TestEqual(TEXT("Slot 1 emptied by the move"), Inventory.GetItemQuantity(1), 0);
+    TestEqual(TEXT("Nothing left queued"), Inventory.FlushCommands(), 0);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#include "InventoryGridWidget.h"
+
+void UInventoryGridWidget::SetGridSize(int32 InNumColumns, int32 InNumRows)
+{
+    NumColumns = FMath::Max(InNumColumns, 0);
+    NumRows = FMath::Max(InNumRows, 0);
+
+    SlotVisuals.Reset();
+    SlotVisuals.SetNum(NumColumns * NumRows);
+
+    if (MyGrid.IsValid())
+        MyGrid->SetGridSize(NumColumns, NumRows);
+}
+
+void UInventoryGridWidget::SetSlot(int32 SlotIndex, bool bShowsItem, const FText& Label)
+{
+    if (!SlotVisuals.IsValidIndex(SlotIndex))
+        return;
+
+    SlotVisuals[SlotIndex].bShowsItem = bShowsItem;
+    SlotVisuals[SlotIndex].Label = Label;
+
+    if (MyGrid.IsValid())
+        MyGrid->SetSlot(SlotIndex, bShowsItem, Label);
+}
+
+int32 UInventoryGridWidget::GetSlotAt(const FVector2D& AbsolutePosition) const
+{
+    return MyGrid.IsValid() ? MyGrid->GetSlotAt(AbsolutePosition) : INDEX_NONE;
+}
+
+int32 UInventoryGridWidget::GetLastPaintDrawElementCount() const
+{
+    return MyGrid.IsValid() ? MyGrid->GetLastPaintDrawElementCount() : 0;
+}
+
+void UInventoryGridWidget::ReleaseSlateResources(bool bReleaseChildren)
+{
+    Super::ReleaseSlateResources(bReleaseChildren);
+
+    MyGrid.Reset();
+}
+
+TSharedRef<SWidget> UInventoryGridWidget::RebuildWidget()
+{
+    MyGrid = SNew(SInventoryGrid)
+        .NumColumns(NumColumns)
+        .NumRows(NumRows);
+
+    for (int32 SlotIndex = 0; SlotIndex < SlotVisuals.Num(); ++SlotIndex)
+        MyGrid->SetSlot(SlotIndex, SlotVisuals[SlotIndex].bShowsItem, SlotVisuals[SlotIndex].Label);
+
+    return MyGrid.ToSharedRef();
+}
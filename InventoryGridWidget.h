@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/Widget.h"
+#include "SInventoryGrid.h"
+#include "InventoryGridWidget.generated.h"
+
+// UMG wrapper of SInventoryGrid, the inventory's leaf renderer mode puts it where the uniform grid of slot widgets would be
+// Slot contents are kept here as well, so a rebuilt Slate widget shows the same thing
+UCLASS()
+class UInventoryGridWidget : public UWidget
+{
+    GENERATED_BODY()
+
+public:
+    void SetGridSize(int32 InNumColumns, int32 InNumRows);
+
+    void SetSlot(int32 SlotIndex, bool bShowsItem, const FText& Label);
+
+    // Returns the slot under an absolute position, INDEX_NONE when there's none (or nothing got built yet)
+    int32 GetSlotAt(const FVector2D& AbsolutePosition) const;
+
+    // Number of draw elements the last paint emitted
+    int32 GetLastPaintDrawElementCount() const;
+
+    virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+protected:
+    virtual TSharedRef<SWidget> RebuildWidget() override;
+
+private:
+    TSharedPtr<SInventoryGrid> MyGrid;
+
+    int32 NumColumns = 0;
+
+    int32 NumRows = 0;
+
+    TArray<FInventoryGridSlotVisual> SlotVisuals;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Hands out unique item IDs, always reusing the smallest released ID first
+// Released IDs live in a min-heap so allocate and release are O(log n) without per-call heap churn
+struct FInventoryIdAllocator
+{
+public:
+    // Forgets every ID and reserves room for ExpectedIds released IDs
+    void Reset(int32 ExpectedIds)
+    {
+        NextFreshId = 0;
+        ReleasedIds.Reset(ExpectedIds);
+        IsReleased.Reset();
+    }
+
+    // Restarts from a set of IDs already in use (a loaded save), every gap below the largest one becomes reusable
+    void Rebuild(TConstArrayView<int32> UsedIds)
+    {
+        // Negative IDs are never handed out, and MAX_int32 would have no fresh ID after it
+        NextFreshId = 0;
+        for (int32 Id : UsedIds)
+        {
+            if (Id >= 0 && Id < MAX_int32)
+                NextFreshId = FMath::Max(NextFreshId, Id + 1);
+        }
+
+        TBitArray<> IsIdUsed(false, NextFreshId);
+        for (int32 Id : UsedIds)
+        {
+            if (Id >= 0 && Id < NextFreshId)
+                IsIdUsed[Id] = true;
+        }
+
+        // Ascending order already is a valid min-heap
+        ReleasedIds.Reset();
+        IsReleased.Init(false, NextFreshId);
+        for (int32 Id = 0; Id < NextFreshId; ++Id)
+        {
+            if (!IsIdUsed[Id])
+            {
+                ReleasedIds.Add(Id);
+                IsReleased[Id] = true;
+            }
+        }
+    }
+
+    // Returns the smallest ID not currently in use
+    int32 Allocate()
+    {
+        if (ReleasedIds.Num() > 0)
+        {
+            int32 Id;
+            ReleasedIds.HeapPop(Id, EAllowShrinking::No);
+            IsReleased[Id] = false;
+            return Id;
+        }
+
+        // Every ID below NextFreshId is in use
+        IsReleased.Add(false);
+        return NextFreshId++;
+    }
+
+    // Gives an ID back so it can be handed out again, releasing it twice is a caller bug and ignored
+    // (a second heap entry would hand the same ID to two items)
+    void Release(int32 Id)
+    {
+        if (Id < 0 || Id >= NextFreshId)
+            return;
+
+        checkSlow(!IsReleased[Id]);
+        if (IsReleased[Id])
+            return;
+
+        IsReleased[Id] = true;
+        ReleasedIds.HeapPush(Id);
+    }
+
+private:
+    // Smallest never allocated ID
+    int32 NextFreshId = 0;
+
+    // Released IDs below NextFreshId, heapified with the smallest on top
+    TArray<int32> ReleasedIds;
+
+    // One bit per ID below NextFreshId, set while the ID sits in ReleasedIds
+    TBitArray<> IsReleased;
+};
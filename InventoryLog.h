@@ -0,0 +1,12 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/LogMacros.h"
+
+// Inventory log category, anything more verbose than the compile time verbosity is stripped from the build
+// (Verbose and below never reach shipping builds, VeryVerbose never reaches any build)
+#if UE_BUILD_SHIPPING
+DECLARE_LOG_CATEGORY_EXTERN(LogInventory, Warning, Warning);
+#else
+DECLARE_LOG_CATEGORY_EXTERN(LogInventory, Log, Verbose);
+#endif
@@ -0,0 +1,486 @@
+#include "InventoryTestHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/ParallelFor.h"
+
+// Hot paths of a single inventory at three grid sizes, driven through the widget's own mouse handlers
+// Writes Saved/Profiling/Inventory/InventoryHotPaths.csv and .json
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryHotPathsPerfTest, "Inventory.Perf.HotPaths", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventoryHotPathsPerfTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumPickups = 64;
+    constexpr int32 NumIterations = 32;
+    constexpr int32 NumWarmupDrags = 4;
+
+    FInventoryPerfReport Report(TEXT("InventoryHotPaths"));
+
+    // 12, 256 and 4096 slots
+    for (const FIntPoint GridSize : { FIntPoint(3, 4), FIntPoint(16, 16), FIntPoint(64, 64) })
+    {
+        FInventoryTestFixture Fixture;
+        if (!Fixture.IsValidFor(*this))
+            return false;
+
+        UInventory& Inventory = Fixture.GetInventory();
+        Fixture.SetGridSize(GridSize.X, GridSize.Y);
+
+        const int32 NumSlots = GridSize.X * GridSize.Y;
+        const FString SizeLabel = FString::Printf(TEXT("%d slots"), NumSlots);
+
+        // Pickup: one AddItem() per actor, items of five kinds so they both stack and take new slots
+        TArray<AActor*> PickupActors;
+        for (int32 PickupIndex = 0; PickupIndex < NumPickups; ++PickupIndex)
+            PickupActors.Add(Fixture.SpawnItemActor(PickupIndex));
+
+        const FInventoryOperationTiming PickupTiming = TimeInventoryOperation(NumPickups,
+            [](int32) {},
+            [&Inventory, &PickupActors](int32 Iteration) { Inventory.AddItem(PickupActors[Iteration]); });
+
+        TestTrue(FString::Printf(TEXT("%s: pickups filled the first two slots"), *SizeLabel), Inventory.GetItemQuantity(0) > 0 && Inventory.GetItemQuantity(1) > 0);
+        Report.AddRow(TEXT("Pickup ") + SizeLabel, PickupTiming.ToValues(NumSlots));
+
+        // Refresh: every slot in view rebuilt
+        const FInventoryOperationTiming RefreshTiming = TimeInventoryOperation(NumIterations,
+            [](int32) {},
+            [&Inventory](int32) { FInventoryTestAccess::RefreshAllSlots(Inventory); });
+
+        Report.AddRow(TEXT("Refresh ") + SizeLabel, RefreshTiming.ToValues(NumSlots));
+
+        // Drag-swap: press slot 0, drag onto slot 1 and release there, back and forth
+        const FInventoryScriptedDrag SwapDrag(Fixture.GetSlotCenter(0), Fixture.GetSlotCenter(1));
+
+        const int32 ItemIdBeforeSwap = Inventory.GetItem(0).Index;
+        SwapDrag.Run(Inventory);
+        TestEqual(FString::Printf(TEXT("%s: scripted drag swapped slot 0 onto slot 1"), *SizeLabel), Inventory.GetItem(1).Index, ItemIdBeforeSwap);
+
+        for (int32 WarmupIndex = 1; WarmupIndex < NumWarmupDrags; ++WarmupIndex)
+            SwapDrag.Run(Inventory);
+
+        const FInventoryOperationTiming SwapTiming = TimeInventoryOperation(NumIterations,
+            [](int32) {},
+            [&Inventory, &SwapDrag](int32) { SwapDrag.Run(Inventory); });
+
+        Report.AddRow(TEXT("DragSwap ") + SizeLabel, SwapTiming.ToValues(NumSlots));
+
+        // Drop: a single item dragged out of slot 0 into the world (a pickup puts it back in between, untimed)
+        for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+            Inventory.RemoveItem(SlotIndex);
+
+        const FInventoryScriptedDrag DropDrag(Fixture.GetSlotCenter(0), Fixture.GetOutsidePosition());
+
+        const FInventoryOperationTiming DropTiming = TimeInventoryOperation(NumIterations,
+            [&Fixture, &Inventory](int32 Iteration) { Inventory.AddItem(Fixture.SpawnItemActor(Iteration)); },
+            [&Inventory, &DropDrag](int32) { DropDrag.Run(Inventory); });
+
+        TestTrue(FString::Printf(TEXT("%s: scripted drops emptied the inventory"), *SizeLabel), Inventory.IsInventoryEmpty());
+        Report.AddRow(TEXT("Drop ") + SizeLabel, DropTiming.ToValues(NumSlots));
+    }
+
+    return Report.Write(*this);
+}
+
+// 8 producer threads enqueue batches of real inventory operations through EnqueueCommand(), the game thread
+// applies each frame's batch with FlushCommands(). Writes Saved/Profiling/Inventory/InventoryCommandQueue.csv and .json
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryCommandQueuePerfTest, "Inventory.Perf.CommandQueue", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventoryCommandQueuePerfTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumProducers = 8;
+    constexpr int32 NumFrames = 16;
+
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+    Fixture.SetGridSize(64, 64);
+    const int32 MaxStackSize = FInventoryTestAccess::GetMaxStackSize(Inventory);
+
+    FInventoryArchetype Archetypes[2];
+    Archetypes[0].WorldObjectReference = AStaticMeshActor::StaticClass();
+    Archetypes[0].StaticMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")));
+    Archetypes[1].WorldObjectReference = AStaticMeshActor::StaticClass();
+    Archetypes[1].StaticMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Sphere.Sphere")));
+
+    FInventoryPerfReport Report(TEXT("InventoryCommandQueue"));
+
+    for (const int32 CommandsPerProducer : { 16, 128, 1024 })
+    {
+        const int32 NumCommands = NumProducers * CommandsPerProducer;
+
+        double EnqueueSeconds = 0.0;
+        FInventoryOperationTiming FlushTiming;
+        FlushTiming.Iterations = NumFrames;
+
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            // Every producer adds loot, moves it around and removes some of it, slots spread over the whole grid
+            const double EnqueueStartSeconds = FPlatformTime::Seconds();
+            ParallelFor(NumProducers, [&Inventory, &Archetypes, CommandsPerProducer, Frame](int32 ProducerIndex)
+            {
+                for (int32 CommandIndex = 0; CommandIndex < CommandsPerProducer; ++CommandIndex)
+                {
+                    const int32 Slot = (ProducerIndex * 521 + CommandIndex * 31 + Frame * 7) % 4096;
+                    switch (CommandIndex % 4)
+                    {
+                        case 0:
+                        case 1:
+                            Inventory.EnqueueCommand(FInventoryCommand::MakeAdd(Archetypes[(CommandIndex / 4) % 2], 1 + CommandIndex % 3));
+                            break;
+                        case 2:
+                            Inventory.EnqueueCommand(FInventoryCommand::MakeMove(Slot, (Slot + 4095) % 4096));
+                            break;
+                        default:
+                            Inventory.EnqueueCommand(FInventoryCommand::MakeRemove(Slot));
+                            break;
+                    }
+                }
+            }, EParallelForFlags::Unbalanced);
+            EnqueueSeconds += FPlatformTime::Seconds() - EnqueueStartSeconds;
+
+            FInventoryAllocationScope AllocationScope;
+            const double FlushStartSeconds = FPlatformTime::Seconds();
+            const int32 NumApplied = Inventory.FlushCommands();
+            const double FlushSeconds = FPlatformTime::Seconds() - FlushStartSeconds;
+            FlushTiming.Allocations += AllocationScope.End();
+
+            FlushTiming.TotalSeconds += FlushSeconds;
+            FlushTiming.MaxSeconds = FMath::Max(FlushTiming.MaxSeconds, FlushSeconds);
+
+            // Interleaving between producers isn't deterministic, so the check is what any order has to leave behind:
+            // everything consumed, and slot contents that agree with the per-archetype counts and stack limits
+            TestTrue(FString::Printf(TEXT("%d commands per frame: some but not more than every command applied"), NumCommands), NumApplied > 0 && NumApplied <= NumCommands);
+            TestEqual(FString::Printf(TEXT("%d commands per frame: nothing left queued"), NumCommands), Inventory.FlushCommands(), 0);
+
+            int32 NumHeldItems = 0;
+            bool bAreStacksWithinLimit = true;
+            for (int32 SlotIndex = 0; SlotIndex < 4096; ++SlotIndex)
+            {
+                const int32 Quantity = Inventory.GetItemQuantity(SlotIndex);
+                NumHeldItems += Quantity;
+                bAreStacksWithinLimit &= Quantity <= MaxStackSize;
+            }
+
+            TestEqual(FString::Printf(TEXT("%d commands per frame: slots hold what the archetype counts say"), NumCommands), NumHeldItems, Inventory.CountItemsByMesh(Archetypes[0].StaticMesh) + Inventory.CountItemsByMesh(Archetypes[1].StaticMesh));
+            TestTrue(FString::Printf(TEXT("%d commands per frame: no stack over its limit"), NumCommands), bAreStacksWithinLimit);
+        }
+
+        TArray<TPair<FString, double>> Values = FlushTiming.ToValues(4096);
+        Values.Emplace(TEXT("OccupiedSlots"), Inventory.GetNumOccupiedSlots());
+        Values.Emplace(TEXT("Producers"), NumProducers);
+        Values.Emplace(TEXT("CommandsPerFrame"), NumCommands);
+        Values.Emplace(TEXT("EnqueueCommandsPerSecond"), NumCommands * NumFrames / FMath::Max(EnqueueSeconds, UE_SMALL_NUMBER));
+        Values.Emplace(TEXT("FlushCommandsPerSecond"), NumCommands * NumFrames / FMath::Max(FlushTiming.TotalSeconds, UE_SMALL_NUMBER));
+        Report.AddRow(FString::Printf(TEXT("Flush %d commands"), NumCommands), MoveTemp(Values));
+    }
+
+    return Report.Write(*this);
+}
+
+// A warmed up drag-swap (press, move, swap, release) makes no heap allocation at all, counted at GMalloc
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryDragAllocationTest, "Inventory.Perf.DragAllocations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventoryDragAllocationTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumWarmupDrags = 4;
+
+    // The counter has to see allocations at all, or a zero below would mean nothing
+    {
+        FInventoryAllocationScope AllocationScope;
+        TArray<int32> Probe;
+        Probe.Reserve(64);
+        if (AllocationScope.End() == 0 || !FInventoryCountingMalloc::Get().IsInstalled())
+        {
+            AddError(TEXT("Heap allocations can't be counted, GMalloc is bypassed or replaced in this build"));
+            return false;
+        }
+    }
+
+    for (const bool bUseLeafGridRenderer : { false, true })
+    {
+        const TCHAR* RendererLabel = bUseLeafGridRenderer ? TEXT("leaf grid") : TEXT("slot widgets");
+
+        FInventoryTestFixture Fixture(bUseLeafGridRenderer);
+        if (!Fixture.IsValidFor(*this))
+            return false;
+
+        UInventory& Inventory = Fixture.GetInventory();
+        Inventory.AddItem(Fixture.SpawnItemActor(0));
+        Inventory.AddItem(Fixture.SpawnItemActor(1));
+        Fixture.Paint();
+
+        const FInventoryScriptedDrag SwapDrag(Fixture.GetSlotCenter(0), Fixture.GetSlotCenter(1));
+
+        // Labels, slot rects and Slate's own invalidation lists all reach their steady size here
+        // (painting in between, like frames would, so nothing piles up waiting for a paint)
+        for (int32 WarmupIndex = 0; WarmupIndex < NumWarmupDrags; ++WarmupIndex)
+        {
+            SwapDrag.Run(Inventory);
+            Fixture.Paint();
+        }
+
+        const int32 ItemIdBeforeSwap = Inventory.GetItem(0).Index;
+
+        FInventoryAllocationScope AllocationScope;
+        SwapDrag.Run(Inventory);
+        const int32 NumAllocations = AllocationScope.End();
+
+        TestEqual(FString::Printf(TEXT("%s: the drag swapped"), RendererLabel), Inventory.GetItem(1).Index, ItemIdBeforeSwap);
+        TestEqual(FString::Printf(TEXT("%s: heap allocations of a warmed up drag-swap"), RendererLabel), NumAllocations, 0);
+        TestEqual(FString::Printf(TEXT("%s: inventory's own allocation count agrees"), RendererLabel), Inventory.GetLastDragAllocationCount(), 0);
+    }
+
+    return true;
+}
+
+// Picking up and removing items over and over keeps one cached label per live item, not one per item ever shown
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryLabelCacheTest, "Inventory.Perf.LabelCache", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventoryLabelCacheTest::RunTest(const FString& Parameters)
+{
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+
+    // Every round holds a different mix of items, stack sizes and indices
+    for (int32 Round = 0; Round < 64; ++Round)
+    {
+        for (int32 PickupIndex = 0; PickupIndex < 12 + Round % 7; ++PickupIndex)
+            Inventory.AddItem(Fixture.SpawnItemActor(PickupIndex * (Round + 1)));
+
+        for (int32 SlotIndex = Round % 3; SlotIndex < 12; SlotIndex += 2)
+            Inventory.RemoveItem(SlotIndex);
+    }
+
+    TestTrue(TEXT("At most one cached label per slot"), FInventoryTestAccess::GetNumItemLabels(Inventory) <= 12);
+
+    Inventory.SetGridSize(3, 4);
+    TestEqual(TEXT("Recreating the grid empties the label cache"), FInventoryTestAccess::GetNumItemLabels(Inventory), 0);
+
+    return true;
+}
+
+// One AddItems() batch against the same actors picked up with one AddItem() each, for 1, 10 and 100 actors
+// The batch defers destroying its source actors to the next tick, the world ticks between iterations (untimed) so
+// that deferred work never piles up. Writes Saved/Profiling/Inventory/InventoryBatchPickup.csv and .json
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryBatchPickupPerfTest, "Inventory.Perf.BatchPickup", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventoryBatchPickupPerfTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumIterations = 16;
+    constexpr int32 NumSlots = 256;
+
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+    UWorld& World = *Fixture.GetWorld();
+    Fixture.SetGridSize(16, 16);
+
+    FInventoryPerfReport Report(TEXT("InventoryBatchPickup"));
+
+    for (const int32 NumActors : { 1, 10, 100 })
+    {
+        TArray<AActor*> PickupActors;
+        PickupActors.Reserve(NumActors);
+
+        // Empty inventory, deferred destroys done and fresh actors of five kinds, so both stacking and new slots get hit
+        auto PrepareIteration = [&](int32)
+        {
+            for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+                Inventory.RemoveItem(SlotIndex);
+
+            World.Tick(LEVELTICK_All, 1.0f / 60.0f);
+
+            PickupActors.Reset();
+            for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+                PickupActors.Add(Fixture.SpawnItemActor(ActorIndex, FVector(ActorIndex * 100.0f, 0.0f, 0.0f)));
+        };
+
+        const FInventoryOperationTiming LoopTiming = TimeInventoryOperation(NumIterations, PrepareIteration,
+            [&Inventory, &PickupActors](int32)
+            {
+                for (AActor* PickupActor : PickupActors)
+                    Inventory.AddItem(PickupActor);
+            });
+
+        const TArray<int32> LoopQuantities = { Inventory.GetItemQuantity(0), Inventory.GetItemQuantity(1), Inventory.GetNumOccupiedSlots() };
+
+        const FInventoryOperationTiming BatchTiming = TimeInventoryOperation(NumIterations, PrepareIteration,
+            [&Inventory, &PickupActors](int32) { Inventory.AddItems(PickupActors); });
+
+        const TArray<int32> BatchQuantities = { Inventory.GetItemQuantity(0), Inventory.GetItemQuantity(1), Inventory.GetNumOccupiedSlots() };
+        TestTrue(FString::Printf(TEXT("%d actors: batch and loop fill the same slots"), NumActors), LoopQuantities == BatchQuantities);
+
+        const double Speedup = BatchTiming.TotalSeconds > 0.0 ? LoopTiming.TotalSeconds / BatchTiming.TotalSeconds : 0.0;
+
+        TArray<TPair<FString, double>> LoopValues = LoopTiming.ToValues(NumSlots);
+        LoopValues.Emplace(TEXT("NumActors"), NumActors);
+        Report.AddRow(FString::Printf(TEXT("AddItem loop %d actors"), NumActors), MoveTemp(LoopValues));
+
+        TArray<TPair<FString, double>> BatchValues = BatchTiming.ToValues(NumSlots);
+        BatchValues.Emplace(TEXT("NumActors"), NumActors);
+        BatchValues.Emplace(TEXT("SpeedupOverLoop"), Speedup);
+        Report.AddRow(FString::Printf(TEXT("AddItems %d actors"), NumActors), MoveTemp(BatchValues));
+    }
+
+    World.Tick(LEVELTICK_All, 1.0f / 60.0f);
+
+    return Report.Write(*this);
+}
+
+// Leaf grid renderer against the widget tree at 12, 256 and 2048 slots: what a resize costs and what every
+// frame paints afterwards. Invalidation caching is off so each paint emits every element.
+// Writes Saved/Profiling/Inventory/InventoryGridRenderer.csv and .json
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryGridRendererPerfTest, "Inventory.Perf.GridRenderer", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventoryGridRendererPerfTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumPaints = 32;
+    constexpr int32 NumPickups = 64;
+
+    FInventoryPerfReport Report(TEXT("InventoryGridRenderer"));
+
+    for (const bool bUseLeafGridRenderer : { false, true })
+    {
+        const TCHAR* RendererLabel = bUseLeafGridRenderer ? TEXT("Leaf") : TEXT("Tree");
+
+        FInventoryTestFixture Fixture(bUseLeafGridRenderer);
+        if (!Fixture.IsValidFor(*this))
+            return false;
+
+        UInventory& Inventory = Fixture.GetInventory();
+
+        // 12, 256 and 2048 slots
+        for (const FIntPoint GridSize : { FIntPoint(3, 4), FIntPoint(16, 16), FIntPoint(32, 64) })
+        {
+            const int32 NumSlots = GridSize.X * GridSize.Y;
+            const FString RowLabel = FString::Printf(TEXT("%s %d slots"), RendererLabel, NumSlots);
+
+            const int32 WidgetAllocationsBefore = FInventoryTestAccess::GetWidgetAllocationCount(Inventory);
+            const double ResizeStartSeconds = FPlatformTime::Seconds();
+            Inventory.SetGridSize(GridSize.X, GridSize.Y);
+            const double ResizeSeconds = FPlatformTime::Seconds() - ResizeStartSeconds;
+            const int32 ResizeWidgetAllocations = FInventoryTestAccess::GetWidgetAllocationCount(Inventory) - WidgetAllocationsBefore;
+
+            // Resizing recreates the body, invalidation box included
+            FInventoryTestAccess::SetBodyCaching(Inventory, false);
+
+            // Labels and item images painted too, not just empty cells
+            for (int32 PickupIndex = 0; PickupIndex < NumPickups; ++PickupIndex)
+                Inventory.AddItem(Fixture.SpawnItemActor(PickupIndex));
+
+            // First paint lays the new grid out, only steady state frames are measured
+            Fixture.Paint();
+
+            int32 NumDrawElements = 0;
+            double TotalPaintSeconds = 0.0;
+            double MaxPaintSeconds = 0.0;
+            for (int32 PaintIndex = 0; PaintIndex < NumPaints; ++PaintIndex)
+            {
+                double PaintSeconds = 0.0;
+                NumDrawElements = Fixture.Paint(1.0f / 60.0f, &PaintSeconds);
+                TotalPaintSeconds += PaintSeconds;
+                MaxPaintSeconds = FMath::Max(MaxPaintSeconds, PaintSeconds);
+            }
+
+            TestTrue(FString::Printf(TEXT("%s: painted something"), *RowLabel), NumDrawElements > 0);
+
+            TArray<TPair<FString, double>> Values;
+            Values.Emplace(TEXT("NumSlots"), NumSlots);
+            Values.Emplace(TEXT("LeafRenderer"), bUseLeafGridRenderer ? 1.0 : 0.0);
+            Values.Emplace(TEXT("ResizeMicroseconds"), ResizeSeconds * 1000000.0);
+            Values.Emplace(TEXT("ResizeWidgetAllocations"), ResizeWidgetAllocations);
+            Values.Emplace(TEXT("SlateWidgets"), Fixture.CountSlateWidgets());
+            Values.Emplace(TEXT("DrawElements"), NumDrawElements);
+            Values.Emplace(TEXT("AveragePaintMicroseconds"), TotalPaintSeconds * 1000000.0 / NumPaints);
+            Values.Emplace(TEXT("MaxPaintMicroseconds"), MaxPaintSeconds * 1000000.0);
+            Report.AddRow(RowLabel, MoveTemp(Values));
+        }
+    }
+
+    return Report.Write(*this);
+}
+
+// Indexed class and mesh queries on a 12 and a 4096 slot grid holding the same items, next to a linear scan of
+// every slot. The indexed queries should cost the same on both grids, only the scan grows with the grid
+// Writes Saved/Profiling/Inventory/InventoryQueries.csv and .json
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryQueryPerfTest, "Inventory.Perf.Queries", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventoryQueryPerfTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumIterations = 64;
+    constexpr int32 QueriesPerIteration = 100;
+    constexpr int32 NumPickups = 40;
+
+    FInventoryPerfReport Report(TEXT("InventoryQueries"));
+
+    const TSubclassOf<AActor> QueryClass = AStaticMeshActor::StaticClass();
+    const TSoftObjectPtr<UStaticMesh> QueryMesh(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")));
+
+    // Average microseconds of every query on the smallest grid, the larger grid's rows are reported relative to it
+    TMap<FString, double> SmallestGridMicroseconds;
+
+    for (const FIntPoint GridSize : { FIntPoint(3, 4), FIntPoint(64, 64) })
+    {
+        FInventoryTestFixture Fixture;
+        if (!Fixture.IsValidFor(*this))
+            return false;
+
+        UInventory& Inventory = Fixture.GetInventory();
+        Fixture.SetGridSize(GridSize.X, GridSize.Y);
+        const int32 NumSlots = GridSize.X * GridSize.Y;
+
+        // Same five stacks on both grids, so every query finds the same matches
+        for (int32 PickupIndex = 0; PickupIndex < NumPickups; ++PickupIndex)
+            Inventory.AddItem(Fixture.SpawnItemActor(PickupIndex));
+
+        TestEqual(FString::Printf(TEXT("%d slots: every pickup counted by class"), NumSlots), Inventory.CountItemsByClass(QueryClass), NumPickups);
+        TestEqual(FString::Printf(TEXT("%d slots: one cube stack found by mesh"), NumSlots), Inventory.FindSlotsByMesh(QueryMesh).Num(), 1);
+
+        int64 Sink = 0;
+        const TPair<const TCHAR*, TFunction<void()>> Queries[] =
+        {
+            { TEXT("FindSlotsByClass"), [&]() { Sink += Inventory.FindSlotsByClass(QueryClass).Num(); } },
+            { TEXT("CountItemsByClass"), [&]() { Sink += Inventory.CountItemsByClass(QueryClass); } },
+            { TEXT("FindSlotsByMesh"), [&]() { Sink += Inventory.FindSlotsByMesh(QueryMesh).Num(); } },
+            { TEXT("CountItemsByMesh"), [&]() { Sink += Inventory.CountItemsByMesh(QueryMesh); } },
+            { TEXT("LinearScan"), [&]()
+                {
+                    for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+                        Sink += Inventory.GetItemQuantity(SlotIndex);
+                } },
+        };
+
+        for (const TPair<const TCHAR*, TFunction<void()>>& Query : Queries)
+        {
+            const FInventoryOperationTiming Timing = TimeInventoryOperation(NumIterations,
+                [](int32) {},
+                [&Query](int32)
+                {
+                    for (int32 QueryIndex = 0; QueryIndex < QueriesPerIteration; ++QueryIndex)
+                        Query.Value();
+                });
+
+            const double QueryMicroseconds = Timing.GetAverageMicroseconds() / QueriesPerIteration;
+            const double SmallestMicroseconds = SmallestGridMicroseconds.FindOrAdd(Query.Key, QueryMicroseconds);
+
+            TArray<TPair<FString, double>> Values = Timing.ToValues(NumSlots);
+            Values.Emplace(TEXT("QueriesPerIteration"), QueriesPerIteration);
+            Values.Emplace(TEXT("QueryMicroseconds"), QueryMicroseconds);
+            Values.Emplace(TEXT("RelativeToSmallestGrid"), SmallestMicroseconds > 0.0 ? QueryMicroseconds / SmallestMicroseconds : 0.0);
+            Report.AddRow(FString::Printf(TEXT("%s %d slots"), Query.Key, NumSlots), MoveTemp(Values));
+        }
+
+        TestTrue(FString::Printf(TEXT("%d slots: queries found items"), NumSlots), Sink > 0);
+    }
+
+    return Report.Write(*this);
+}
+
+#endif
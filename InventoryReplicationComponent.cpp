@@ -0,0 +1,224 @@
+#include "InventoryReplicationComponent.h"
+#include "Inventory.h"
+#include "Net/UnrealNetwork.h"
+
+void FInventoryReplicatedSlot::PostReplicatedAdd(const FInventoryReplicatedSlotArray& InArraySerializer)
+{
+    if (InArraySerializer.Owner)
+        InArraySerializer.Owner->OnSlotReplicated(*this);
+}
+
+void FInventoryReplicatedSlot::PostReplicatedChange(const FInventoryReplicatedSlotArray& InArraySerializer)
+{
+    if (InArraySerializer.Owner)
+        InArraySerializer.Owner->OnSlotReplicated(*this);
+}
+
+bool FInventoryReplicatedSlot::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    // Shifted by one so INDEX_NONE packs into a single byte like every other small value
+    uint32 PackedSlotIndex = uint32(SlotIndex + 1);
+    uint32 PackedArchetype = uint32(Archetype + 1);
+    uint32 PackedItemId = uint32(ItemId + 1);
+    uint32 PackedQuantity = uint32(FMath::Max(Quantity, 0));
+
+    Ar.SerializeIntPacked(PackedSlotIndex);
+    Ar.SerializeIntPacked(PackedArchetype);
+    Ar.SerializeIntPacked(PackedItemId);
+    Ar.SerializeIntPacked(PackedQuantity);
+
+    if (Ar.IsLoading())
+    {
+        SlotIndex = int32(PackedSlotIndex) - 1;
+        Archetype = int32(PackedArchetype) - 1;
+        ItemId = int32(PackedItemId) - 1;
+        Quantity = int32(PackedQuantity);
+    }
+
+    bOutSuccess = !Ar.IsError();
+    return true;
+}
+
+void FInventoryReplicatedSlotArray::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+    if (Owner)
+        Owner->FlushReplicatedSlots();
+}
+
+bool FInventoryReplicatedSlotArray::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+    const int64 StartBits = DeltaParms.Writer ? DeltaParms.Writer->GetNumBits() : 0;
+
+    const bool bWroteDelta = FFastArraySerializer::FastArrayDeltaSerialize<FInventoryReplicatedSlot, FInventoryReplicatedSlotArray>(Items, DeltaParms, *this);
+
+    if (DeltaParms.Writer && Owner && bWroteDelta)
+        Owner->RecordDeltaBits(DeltaParms.Writer->GetNumBits() - StartBits);
+
+    return bWroteDelta;
+}
+
+UInventoryReplicationComponent::UInventoryReplicationComponent(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer),
+      LastDeltaBits(0),
+      TotalDeltaBits(0),
+      NumDeltasSent(0)
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    SetIsReplicatedByDefault(true);
+
+    Slots.Owner = this;
+}
+
+void UInventoryReplicationComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(UInventoryReplicationComponent, Slots);
+    DOREPLIFETIME(UInventoryReplicationComponent, Archetypes);
+}
+
+void UInventoryReplicationComponent::SetBoundInventory(UInventory* Inventory)
+{
+    BoundInventory = Inventory;
+    LocalArchetypeHandles.Reset();
+
+    // A client binding late still has to show whatever already arrived
+    if (!HasAuthority())
+    {
+        QueueAllReplicatedSlots();
+        OnRep_Archetypes();
+    }
+}
+
+void UInventoryReplicationComponent::ResetSlots(int32 NumSlots)
+{
+    if (!HasAuthority())
+        return;
+
+    Archetypes.Reset();
+
+    Slots.Items.Reset(NumSlots);
+    for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+    {
+        FInventoryReplicatedSlot& Slot = Slots.Items.AddDefaulted_GetRef();
+        Slot.SlotIndex = SlotIndex;
+        Slots.MarkItemDirty(Slot);
+    }
+
+    Slots.MarkArrayDirty();
+}
+
+void UInventoryReplicationComponent::PushSlot(int32 SlotIndex, const FInventorySlotEntry& Entry, const FInventoryArchetypeTable& ArchetypeTable)
+{
+    if (!HasAuthority() || !Slots.Items.IsValidIndex(SlotIndex))
+        return;
+
+    // Archetypes the slot may refer to have to reach clients too, the table only ever grows
+    for (int32 ArchetypeHandle = Archetypes.Num(); ArchetypeHandle < ArchetypeTable.Num(); ++ArchetypeHandle)
+        Archetypes.Add(ArchetypeTable.Get(ArchetypeHandle));
+
+    FInventoryReplicatedSlot& Slot = Slots.Items[SlotIndex];
+    if (Slot.Archetype == Entry.Archetype && Slot.ItemId == Entry.ItemId && Slot.Quantity == Entry.Quantity)
+        return;
+
+    Slot.Archetype = Entry.Archetype;
+    Slot.ItemId = Entry.ItemId;
+    Slot.Quantity = Entry.Quantity;
+    Slots.MarkItemDirty(Slot);
+}
+
+int32 UInventoryReplicationComponent::GetLastDeltaBytes() const
+{
+    return int32((LastDeltaBits + 7) / 8);
+}
+
+int64 UInventoryReplicationComponent::GetTotalDeltaBytes() const
+{
+    return (TotalDeltaBits + 7) / 8;
+}
+
+int32 UInventoryReplicationComponent::GetNumDeltasSent() const
+{
+    return NumDeltasSent;
+}
+
+void UInventoryReplicationComponent::RecordDeltaBits(int64 NumBits)
+{
+    LastDeltaBits = NumBits;
+    TotalDeltaBits += NumBits;
+    ++NumDeltasSent;
+}
+
+void UInventoryReplicationComponent::OnSlotReplicated(const FInventoryReplicatedSlot& Slot)
+{
+    // The payload travels with its slot index, the client's array order differs from the server's
+    PendingSlots.Add(Slot.SlotIndex, Slot);
+}
+
+void UInventoryReplicationComponent::FlushReplicatedSlots()
+{
+    UInventory* Inventory = BoundInventory.Get();
+    if (!Inventory || PendingSlots.Num() == 0)
+        return;
+
+    TMap<int32, FInventorySlotEntry> ChangedSlots;
+    ChangedSlots.Reserve(PendingSlots.Num());
+
+    for (auto It = PendingSlots.CreateIterator(); It; ++It)
+    {
+        const FInventoryReplicatedSlot& Slot = It.Value();
+
+        FInventorySlotEntry Entry;
+        if (Slot.Archetype != INDEX_NONE)
+        {
+            // Archetype not mapped yet, the slot stays pending and OnRep_Archetypes flushes again once it is
+            if (!LocalArchetypeHandles.IsValidIndex(Slot.Archetype))
+                continue;
+
+            Entry.Archetype = LocalArchetypeHandles[Slot.Archetype];
+            Entry.ItemId = Slot.ItemId;
+            Entry.Quantity = Slot.Quantity;
+        }
+
+        ChangedSlots.Add(Slot.SlotIndex, Entry);
+        It.RemoveCurrent();
+    }
+
+    if (ChangedSlots.Num() > 0)
+        Inventory->ApplyReplicatedSlots(ChangedSlots);
+}
+
+void UInventoryReplicationComponent::ServerMoveSlot_Implementation(int32 FromSlot, int32 ToSlot)
+{
+    // Applied with the next command flush, which validates both slots like any other queued move
+    if (UInventory* Inventory = BoundInventory.Get())
+        Inventory->EnqueueCommand(FInventoryCommand::MakeMove(FromSlot, ToSlot));
+}
+
+void UInventoryReplicationComponent::QueueAllReplicatedSlots()
+{
+    PendingSlots.Reserve(Slots.Items.Num());
+    for (const FInventoryReplicatedSlot& Slot : Slots.Items)
+        PendingSlots.Add(Slot.SlotIndex, Slot);
+}
+
+bool UInventoryReplicationComponent::HasAuthority() const
+{
+    const AActor* Owner = GetOwner();
+    return Owner && Owner->HasAuthority();
+}
+
+void UInventoryReplicationComponent::OnRep_Archetypes()
+{
+    UInventory* Inventory = BoundInventory.Get();
+    if (!Inventory)
+        return;
+
+    // Interning is idempotent, so remapping everything is fine for a table that rarely changes
+    LocalArchetypeHandles.Reset(Archetypes.Num());
+    for (const FInventoryArchetype& Archetype : Archetypes)
+        LocalArchetypeHandles.Add(Inventory->InternReplicatedArchetype(Archetype));
+
+    // Slots that arrived before their archetype are still pending
+    FlushReplicatedSlots();
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "InventoryArchetype.h"
+#include "InventoryReplicationComponent.generated.h"
+
+class UInventory;
+class UInventoryReplicationComponent;
+struct FInventoryReplicatedSlotArray;
+
+// One inventory slot as replicated to clients, the world transform stays on the server (only drops need it)
+USTRUCT()
+struct FInventoryReplicatedSlot : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 SlotIndex = INDEX_NONE;
+
+    // Server side archetype handle, clients map it to their own table
+    UPROPERTY()
+    int32 Archetype = INDEX_NONE;
+
+    UPROPERTY()
+    int32 ItemId = INDEX_NONE;
+
+    UPROPERTY()
+    int32 Quantity = 0;
+
+    void PostReplicatedAdd(const FInventoryReplicatedSlotArray& InArraySerializer);
+
+    void PostReplicatedChange(const FInventoryReplicatedSlotArray& InArraySerializer);
+
+    // Every value is small, packing them keeps a changed slot at a few bytes
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FInventoryReplicatedSlot> : public TStructOpsTypeTraitsBase2<FInventoryReplicatedSlot>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
+
+// Fast array of every slot, only slots marked dirty since the last update get sent
+USTRUCT()
+struct FInventoryReplicatedSlotArray : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FInventoryReplicatedSlot> Items;
+
+    // Not replicated, set by the owning component so items can report back to it
+    UPROPERTY(NotReplicated)
+    TObjectPtr<UInventoryReplicationComponent> Owner = nullptr;
+
+    void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FInventoryReplicatedSlotArray> : public TStructOpsTypeTraitsBase2<FInventoryReplicatedSlotArray>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
+
+// Replicates an inventory's slots as deltas. Add it to the owning (replicated) actor and bind the widget
+// to it with UInventory::BindReplication(), the server pushes slot changes and clients apply them
+UCLASS(ClassGroup = (Inventory), meta = (BlueprintSpawnableComponent))
+class UInventoryReplicationComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UInventoryReplicationComponent(const FObjectInitializer& ObjectInitializer);
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    void SetBoundInventory(UInventory* Inventory);
+
+    // ******************** Server ********************
+
+    // Empties every replicated slot and archetype (the inventory got recreated)
+    void ResetSlots(int32 NumSlots);
+
+    // Copies a slot's new content and marks only that slot for replication
+    void PushSlot(int32 SlotIndex, const FInventorySlotEntry& Entry, const FInventoryArchetypeTable& ArchetypeTable);
+
+    // Size of the last delta sent, measured inside NetDeltaSerialize
+    int32 GetLastDeltaBytes() const;
+
+    // Total size of every delta sent and how many there were
+    int64 GetTotalDeltaBytes() const;
+
+    int32 GetNumDeltasSent() const;
+
+    void RecordDeltaBits(int64 NumBits);
+
+    // ******************** Client ********************
+
+    // Keeps the received slot until the next flush, a slot received twice only keeps its latest content
+    void OnSlotReplicated(const FInventoryReplicatedSlot& Slot);
+
+    // Applies every slot received so far to the bound inventory with a single refresh
+    // (slots whose archetype hasn't arrived yet stay pending until it does)
+    void FlushReplicatedSlots();
+
+    // Asks the server to move a slot onto another one (merge or swap, like a drag released there)
+    // Clients never rearrange their own slots, the result comes back through replication. Needs an owning connection
+    UFUNCTION(Server, Reliable)
+    void ServerMoveSlot(int32 FromSlot, int32 ToSlot);
+
+    // Whether the owning actor is the authoritative copy (server, or standalone)
+    bool HasAuthority() const;
+
+private:
+    // Automation tests serialize the slot array directly (see InventoryTestHarness.h)
+    friend struct FInventoryTestAccess;
+
+    // Queues every replicated slot for the next flush (a newly bound inventory has to show all of them)
+    void QueueAllReplicatedSlots();
+
+    UFUNCTION()
+    void OnRep_Archetypes();
+
+    UPROPERTY(Replicated)
+    FInventoryReplicatedSlotArray Slots;
+
+    // Mirrors the server archetype table, it only grows so only new entries get sent
+    UPROPERTY(ReplicatedUsing = OnRep_Archetypes)
+    TArray<FInventoryArchetype> Archetypes;
+
+    TWeakObjectPtr<UInventory> BoundInventory;
+
+    // Client archetype handle for every server archetype handle
+    TArray<int32> LocalArchetypeHandles;
+
+    // Slots received but not applied yet, by slot index (the client's item order isn't the server's)
+    TMap<int32, FInventoryReplicatedSlot> PendingSlots;
+
+    int64 LastDeltaBits;
+
+    int64 TotalDeltaBits;
+
+    int32 NumDeltasSent;
+};
@@ -0,0 +1,142 @@
+#include "InventoryTestHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Net/RepLayout.h"
+#include "Net/Serialization/FastArraySerializer.h"
+
+namespace
+{
+    UInventoryReplicationComponent* AddReplicationComponent(UWorld& World, ENetRole Role)
+    {
+        AActor* Owner = World.SpawnActor<AActor>();
+        if (!Owner)
+            return nullptr;
+
+        Owner->SetRole(Role);
+
+        UInventoryReplicationComponent* Replication = NewObject<UInventoryReplicationComponent>(Owner);
+        Replication->RegisterComponent();
+        return Replication;
+    }
+
+    // Writes the slot array the way the net driver does, against OldState (nullptr for a full baseline)
+    bool SerializeSlots(UInventoryReplicationComponent& Replication, INetDeltaBaseState* OldState, TSharedPtr<INetDeltaBaseState>& OutNewState)
+    {
+        FNetBitWriter Writer(nullptr, 64 * 1024 * 8);
+
+        // Slots serialize natively, so no rep layout (and no net driver) is ever needed
+        FNetSerializeCB SerializeCB(nullptr);
+
+        FNetDeltaSerializeInfo DeltaParms;
+        DeltaParms.Writer = &Writer;
+        DeltaParms.OldState = OldState;
+        DeltaParms.NewState = &OutNewState;
+        DeltaParms.NetSerializeCB = &SerializeCB;
+        DeltaParms.Object = &Replication;
+
+        return FInventoryTestAccess::GetReplicatedSlots(Replication).NetDeltaSerialize(DeltaParms);
+    }
+}
+
+// One swap on the server has to replicate as a small delta, not as the whole slot array
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryReplicationSwapDeltaTest, "Inventory.Replication.SwapDelta", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInventoryReplicationSwapDeltaTest::RunTest(const FString& Parameters)
+{
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+    Fixture.SetGridSize(16, 16);
+
+    UInventoryReplicationComponent* Replication = AddReplicationComponent(*Fixture.GetWorld(), ROLE_Authority);
+    if (!TestNotNull(TEXT("Replication component"), Replication))
+        return false;
+
+    Inventory.BindReplication(Replication);
+    Inventory.AddItem(Fixture.SpawnItemActor(0));
+    Inventory.AddItem(Fixture.SpawnItemActor(1));
+
+    TSharedPtr<INetDeltaBaseState> BaseState;
+    TestTrue(TEXT("Baseline written"), SerializeSlots(*Replication, nullptr, BaseState));
+    const int32 BaselineBytes = Replication->GetLastDeltaBytes();
+
+    // The swap a user makes, through the mouse handlers
+    FInventoryScriptedDrag(Fixture.GetSlotCenter(0), Fixture.GetSlotCenter(1)).Run(Inventory);
+
+    TSharedPtr<INetDeltaBaseState> SwapState;
+    TestTrue(TEXT("Swap delta written"), SerializeSlots(*Replication, BaseState.Get(), SwapState));
+
+    const int32 SwapDeltaBytes = Replication->GetLastDeltaBytes();
+    AddInfo(FString::Printf(TEXT("Baseline of 256 slots: %d bytes, swap delta: %d bytes"), BaselineBytes, SwapDeltaBytes));
+    TestTrue(TEXT("A swap replicates in less than 64 bytes"), SwapDeltaBytes < 64);
+
+    return true;
+}
+
+// Clients apply a received slot to the slot it names, whatever position it has in their copy of the array,
+// and never change their own slots
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryReplicationClientApplyTest, "Inventory.Replication.ClientApply", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInventoryReplicationClientApplyTest::RunTest(const FString& Parameters)
+{
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+
+    UInventoryReplicationComponent* Replication = AddReplicationComponent(*Fixture.GetWorld(), ROLE_SimulatedProxy);
+    if (!TestNotNull(TEXT("Replication component"), Replication))
+        return false;
+
+    FInventoryArchetype Archetype;
+    Archetype.WorldObjectReference = AStaticMeshActor::StaticClass();
+    Archetype.StaticMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")));
+    FInventoryTestAccess::GetReplicatedArchetypes(*Replication).Add(Archetype);
+
+    Inventory.BindReplication(Replication);
+
+    // Array order on a client follows what it received, slot 5 sitting first is perfectly normal
+    TArray<FInventoryReplicatedSlot>& ReceivedSlots = FInventoryTestAccess::GetReplicatedSlots(*Replication).Items;
+
+    FInventoryReplicatedSlot& Received = ReceivedSlots.AddDefaulted_GetRef();
+    Received.SlotIndex = 5;
+    Received.Archetype = 0;
+    Received.ItemId = 42;
+    Received.Quantity = 3;
+
+    FInventoryReplicatedSlot& ReceivedEmpty = ReceivedSlots.AddDefaulted_GetRef();
+    ReceivedEmpty.SlotIndex = 0;
+
+    for (const FInventoryReplicatedSlot& Slot : ReceivedSlots)
+        Replication->OnSlotReplicated(Slot);
+    Replication->FlushReplicatedSlots();
+
+    TestEqual(TEXT("Slot 5 holds the received stack"), Inventory.GetItemQuantity(5), 3);
+    TestEqual(TEXT("Slot 5 holds the received item index"), Inventory.GetItem(5).Index, 42);
+    TestEqual(TEXT("Slot 0 stays empty"), Inventory.GetItemQuantity(0), 0);
+
+    // A server side chest queuing a transfer into the client inventory goes through the same refusal
+    UInventory& Chest = Fixture.AddOtherInventory(3, 4);
+    Chest.EnqueueCommand(FInventoryCommand::MakeAdd(Archetype));
+    Chest.FlushCommands();
+    Chest.EnqueueCommand(FInventoryCommand::MakeTransfer(0, &Inventory));
+
+    AddExpectedError(TEXT("replicated client"), EAutomationExpectedErrorFlags::Contains, 3);
+    Inventory.AddItem(Fixture.SpawnItemActor(1));
+    Inventory.RemoveItem(5);
+
+    TestEqual(TEXT("Client pickups don't touch the slots"), Inventory.GetNumOccupiedSlots(), 1);
+    TestEqual(TEXT("Client removals don't touch the slots"), Inventory.GetItemQuantity(5), 3);
+
+    TestEqual(TEXT("Transfer into a client refused"), Chest.FlushCommands(), 0);
+    TestEqual(TEXT("Chest keeps the refused item"), Chest.GetItemQuantity(0), 1);
+    TestEqual(TEXT("Client slots untouched by the transfer"), Inventory.GetNumOccupiedSlots(), 1);
+
+    return true;
+}
+
+#endif
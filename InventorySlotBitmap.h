@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Occupancy bitmap of inventory slots (one bit per slot, set when the slot holds an item)
+// Free slot lookups scan 64 slots per word and full/empty/occupied queries are O(1)
+struct FInventorySlotBitmap
+{
+public:
+    // Resizes the bitmap to hold NumSlots slots, all of them free
+    void Init(int32 NumSlots)
+    {
+        NumBits = NumSlots;
+        NumOccupied = 0;
+        FirstFreeWordHint = 0;
+        Words.Init(0, FMath::DivideAndRoundUp(NumSlots, BitsPerWord));
+    }
+
+    // Marks a slot as occupied or free
+    void Set(int32 SlotIndex, bool bOccupied)
+    {
+        if (SlotIndex < 0 || SlotIndex >= NumBits)
+            return;
+
+        const int32 WordIndex = SlotIndex / BitsPerWord;
+        const uint64 Mask = uint64(1) << (SlotIndex % BitsPerWord);
+        const bool bWasOccupied = (Words[WordIndex] & Mask) != 0;
+
+        if (bOccupied == bWasOccupied)
+            return;
+
+        if (bOccupied)
+        {
+            Words[WordIndex] |= Mask;
+            ++NumOccupied;
+        }
+        else
+        {
+            Words[WordIndex] &= ~Mask;
+            --NumOccupied;
+
+            // Freed slot may now be the first free one
+            FirstFreeWordHint = FMath::Min(FirstFreeWordHint, WordIndex);
+        }
+    }
+
+    bool IsOccupied(int32 SlotIndex) const
+    {
+        if (SlotIndex < 0 || SlotIndex >= NumBits)
+            return false;
+
+        return (Words[SlotIndex / BitsPerWord] & (uint64(1) << (SlotIndex % BitsPerWord))) != 0;
+    }
+
+    // Returns the first free slot, or INDEX_NONE when every slot is occupied
+    int32 FindFirstFree() const
+    {
+        if (IsFull())
+            return INDEX_NONE;
+
+        // Every word before the hint is known to be full
+        const int32 SlotIndex = FindFirstFreeFromWord(FirstFreeWordHint, ~uint64(0));
+        FirstFreeWordHint = SlotIndex == INDEX_NONE ? Words.Num() : SlotIndex / BitsPerWord;
+        return SlotIndex;
+    }
+
+    // Returns the first free slot at or after StartSlot, or INDEX_NONE when there's none
+    int32 FindFirstFreeFrom(int32 StartSlot) const
+    {
+        if (IsFull() || StartSlot >= NumBits)
+            return INDEX_NONE;
+
+        StartSlot = FMath::Max(StartSlot, 0);
+
+        // Words before the hint are known to be full, so jump straight to it
+        const int32 StartWord = StartSlot / BitsPerWord;
+        if (StartWord < FirstFreeWordHint)
+            return FindFirstFreeFromWord(FirstFreeWordHint, ~uint64(0));
+
+        // Ignore the bits below StartSlot in its own word
+        return FindFirstFreeFromWord(StartWord, ~uint64(0) << (StartSlot % BitsPerWord));
+    }
+
+    int32 Num() const { return NumBits; }
+
+    int32 NumOccupiedSlots() const { return NumOccupied; }
+
+    bool IsFull() const { return NumOccupied == NumBits; }
+
+    bool IsEmpty() const { return NumOccupied == 0; }
+
+private:
+    // Scans words from FirstWord on, FirstWordMask filters which bits of the first word may be returned
+    int32 FindFirstFreeFromWord(int32 FirstWord, uint64 FirstWordMask) const
+    {
+        for (int32 WordIndex = FirstWord; WordIndex < Words.Num(); ++WordIndex)
+        {
+            uint64 FreeBits = ~Words[WordIndex];
+            if (WordIndex == FirstWord)
+                FreeBits &= FirstWordMask;
+
+            if (FreeBits == 0)
+                continue;
+
+            const int32 SlotIndex = WordIndex * BitsPerWord + int32(FMath::CountTrailingZeros64(FreeBits));
+
+            // Bits past the last slot of the last word are never valid slots
+            return SlotIndex < NumBits ? SlotIndex : INDEX_NONE;
+        }
+
+        return INDEX_NONE;
+    }
+
+    static constexpr int32 BitsPerWord = 64;
+
+    TArray<uint64> Words;
+
+    int32 NumBits = 0;
+
+    int32 NumOccupied = 0;
+
+    // Lowest word that may still contain a free slot (lets repeated lookups skip full words)
+    mutable int32 FirstFreeWordHint = 0;
+};
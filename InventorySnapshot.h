@@ -0,0 +1,357 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryArchetype.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// Binary inventory snapshot layout (little endian)
+//
+//   Header     Magic, Version, NumSlots, NumStrings, NumArchetypes, NumRecords, RecordsOffset
+//   Strings    every distinct soft object path once (class, mesh and material paths)
+//   Archetypes class string, mesh string, material count and material strings
+//   Records    NumRecords fixed size records, one per occupied slot, read straight from the mapping one at a time
+namespace InventorySnapshot
+{
+    // "INVS"
+    constexpr uint32 Magic = 0x53564E49;
+
+    // Bump whenever the layout changes, the reader refuses anything newer than this
+    constexpr uint32 Version = 1;
+
+    // Slot, archetype, item id and quantity plus rotation, translation and scale packed as floats
+    constexpr int64 RecordSize = 4 * sizeof(int32) + 10 * sizeof(float);
+
+    // Smallest encodings, used to bound counts read from a file before reserving for them
+    // (a string is at least its length, an archetype at least its class, mesh and material count)
+    constexpr int64 MinStringSize = sizeof(int32);
+    constexpr int64 MinArchetypeSize = 3 * sizeof(int32);
+}
+
+// One occupied slot as stored in a snapshot
+struct FInventorySnapshotRecord
+{
+    int32 SlotIndex = INDEX_NONE;
+
+    // Index into the snapshot's archetypes (not a live archetype table handle)
+    int32 Archetype = INDEX_NONE;
+
+    int32 ItemId = INDEX_NONE;
+
+    int32 Quantity = 0;
+
+    FTransform Transform = FTransform::Identity;
+};
+
+// Collects an inventory on the game thread, encoding can then run on any thread
+struct FInventorySnapshotWriter
+{
+public:
+    void SetNumSlots(int32 InNumSlots)
+    {
+        NumSlots = InNumSlots;
+    }
+
+    // Adds an archetype and returns its snapshot index, archetypes are expected to be added in handle order
+    int32 AddArchetype(const FInventoryArchetype& Archetype)
+    {
+        FArchetypeStrings& Strings = Archetypes.AddDefaulted_GetRef();
+        Strings.ClassString = AddString(FSoftObjectPath(Archetype.WorldObjectReference.Get()).ToString());
+        Strings.MeshString = AddString(Archetype.StaticMesh.ToSoftObjectPath().ToString());
+
+        Strings.MaterialStrings.Reserve(Archetype.StoredMaterials.Num());
+        for (const TSoftObjectPtr<UMaterialInterface>& Material : Archetype.StoredMaterials)
+            Strings.MaterialStrings.Add(AddString(Material.ToSoftObjectPath().ToString()));
+
+        return Archetypes.Num() - 1;
+    }
+
+    void AddRecord(const FInventorySnapshotRecord& Record)
+    {
+        Records.Add(Record);
+    }
+
+    // Archives need mutable values, so encoding isn't const (the writer is meant to be encoded once anyway)
+    void Encode(TArray<uint8>& OutBytes)
+    {
+        FMemoryWriter Writer(OutBytes);
+
+        uint32 Magic = InventorySnapshot::Magic;
+        uint32 Version = InventorySnapshot::Version;
+        int32 NumSlotsToWrite = NumSlots;
+        int32 NumStrings = Strings.Num();
+        int32 NumArchetypes = Archetypes.Num();
+        int32 NumRecords = Records.Num();
+        int64 RecordsOffset = 0;
+
+        Writer << Magic << Version << NumSlotsToWrite << NumStrings << NumArchetypes << NumRecords;
+
+        // Patched once the variable sized sections are written
+        const int64 RecordsOffsetPosition = Writer.Tell();
+        Writer << RecordsOffset;
+
+        for (FString& String : Strings)
+            Writer << String;
+
+        for (FArchetypeStrings& Archetype : Archetypes)
+        {
+            int32 NumMaterials = Archetype.MaterialStrings.Num();
+            Writer << Archetype.ClassString << Archetype.MeshString << NumMaterials;
+
+            for (int32& MaterialString : Archetype.MaterialStrings)
+                Writer << MaterialString;
+        }
+
+        RecordsOffset = Writer.Tell();
+        OutBytes.Reserve(int32(RecordsOffset + Records.Num() * InventorySnapshot::RecordSize));
+
+        for (FInventorySnapshotRecord& Record : Records)
+        {
+            Writer << Record.SlotIndex << Record.Archetype << Record.ItemId << Record.Quantity;
+
+            FQuat4f Rotation(Record.Transform.GetRotation());
+            FVector3f Translation(Record.Transform.GetTranslation());
+            FVector3f Scale(Record.Transform.GetScale3D());
+            Writer << Rotation.X << Rotation.Y << Rotation.Z << Rotation.W;
+            Writer << Translation.X << Translation.Y << Translation.Z;
+            Writer << Scale.X << Scale.Y << Scale.Z;
+        }
+
+        Writer.Seek(RecordsOffsetPosition);
+        Writer << RecordsOffset;
+    }
+
+private:
+    struct FArchetypeStrings
+    {
+        int32 ClassString = INDEX_NONE;
+        int32 MeshString = INDEX_NONE;
+        TArray<int32> MaterialStrings;
+    };
+
+    // Same paths show up in many archetypes (shared materials), every path is stored once
+    int32 AddString(const FString& String)
+    {
+        if (const int32* Existing = StringIndices.Find(String))
+            return *Existing;
+
+        const int32 StringIndex = Strings.Add(String);
+        StringIndices.Add(String, StringIndex);
+        return StringIndex;
+    }
+
+    int32 NumSlots = 0;
+
+    TArray<FString> Strings;
+
+    TMap<FString, int32> StringIndices;
+
+    TArray<FArchetypeStrings> Archetypes;
+
+    TArray<FInventorySnapshotRecord> Records;
+};
+
+// Memory maps a snapshot file, strings and archetypes get decoded on open, records one GetRecord() call at a time
+// (never copied out as a whole, a load walks them in order without holding more than one)
+class FInventorySnapshotReader
+{
+public:
+    // Returns false when the file is missing, truncated, corrupt or written by a newer version
+    bool Open(const FString& FilePath)
+    {
+        Close();
+
+        IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        MappedFile.Reset(PlatformFile.OpenMapped(*FilePath));
+        if (MappedFile.IsValid())
+            MappedRegion.Reset(MappedFile->MapRegion());
+
+        if (MappedRegion.IsValid())
+        {
+            Data = TArrayView<const uint8>(MappedRegion->GetMappedPtr(), int32(MappedRegion->GetMappedSize()));
+        }
+        else
+        {
+            // Platform can't map files, reading it whole is the only option left
+            MappedFile.Reset();
+            if (!FFileHelper::LoadFileToArray(FallbackBytes, *FilePath))
+                return false;
+
+            Data = FallbackBytes;
+        }
+
+        if (!DecodeTables())
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void Close()
+    {
+        MappedRegion.Reset();
+        MappedFile.Reset();
+        FallbackBytes.Empty();
+        Data = TArrayView<const uint8>();
+        Archetypes.Empty();
+        NumSlots = 0;
+        NumRecords = 0;
+        RecordsOffset = 0;
+    }
+
+    int32 GetNumSlots() const { return NumSlots; }
+
+    int32 GetNumRecords() const { return NumRecords; }
+
+    const TArray<FInventoryArchetype>& GetArchetypes() const { return Archetypes; }
+
+    // Decodes a single record straight from the mapped file, a record with SlotIndex INDEX_NONE when it can't be read
+    FInventorySnapshotRecord GetRecord(int32 RecordIndex) const
+    {
+        FInventorySnapshotRecord Record;
+        if (RecordIndex < 0 || RecordIndex >= NumRecords)
+            return Record;
+
+        FMemoryReaderView Reader(Data);
+        Reader.Seek(RecordsOffset + int64(RecordIndex) * InventorySnapshot::RecordSize);
+        Reader << Record.SlotIndex << Record.Archetype << Record.ItemId << Record.Quantity;
+
+        FQuat4f Rotation;
+        FVector3f Translation;
+        FVector3f Scale;
+        Reader << Rotation.X << Rotation.Y << Rotation.Z << Rotation.W;
+        Reader << Translation.X << Translation.Y << Translation.Z;
+        Reader << Scale.X << Scale.Y << Scale.Z;
+
+        if (Reader.IsError())
+            return FInventorySnapshotRecord();
+
+        Record.Transform = FTransform(FQuat(Rotation), FVector(Translation), FVector(Scale));
+        return Record;
+    }
+
+private:
+    bool DecodeTables()
+    {
+        FMemoryReaderView Reader(Data);
+
+        uint32 Magic = 0;
+        uint32 Version = 0;
+        int32 NumStrings = 0;
+        int32 NumArchetypes = 0;
+        Reader << Magic << Version << NumSlots << NumStrings << NumArchetypes << NumRecords << RecordsOffset;
+
+        if (Reader.IsError() || Magic != InventorySnapshot::Magic || Version == 0 || Version > InventorySnapshot::Version)
+            return false;
+
+        if (NumStrings < 0 || NumArchetypes < 0 || NumRecords < 0)
+            return false;
+
+        // Written so no corrupt offset or count can overflow the bound check
+        const int64 DataSize = Data.Num();
+        if (RecordsOffset < 0 || RecordsOffset > DataSize || int64(NumRecords) * InventorySnapshot::RecordSize > DataSize - RecordsOffset)
+            return false;
+
+        // Strings and archetypes sit between the header and the records, every count read below is checked against
+        // what's left of that before anything gets reserved, so a corrupt count can't make us allocate past the file
+        if (!FitsBeforeRecords(Reader, NumStrings, InventorySnapshot::MinStringSize))
+            return false;
+
+        TArray<FSoftObjectPath> Strings;
+        Strings.Reserve(NumStrings);
+        for (int32 StringIndex = 0; StringIndex < NumStrings; ++StringIndex)
+        {
+            FString String;
+            if (!ReadString(Reader, String))
+                return false;
+
+            Strings.Emplace(String);
+        }
+
+        if (!FitsBeforeRecords(Reader, NumArchetypes, InventorySnapshot::MinArchetypeSize))
+            return false;
+
+        Archetypes.Reserve(NumArchetypes);
+        for (int32 ArchetypeIndex = 0; ArchetypeIndex < NumArchetypes && !Reader.IsError(); ++ArchetypeIndex)
+        {
+            int32 ClassString = INDEX_NONE;
+            int32 MeshString = INDEX_NONE;
+            int32 NumMaterials = 0;
+            Reader << ClassString << MeshString << NumMaterials;
+
+            if (!Strings.IsValidIndex(ClassString) || !Strings.IsValidIndex(MeshString) || NumMaterials < 0)
+                return false;
+
+            if (!FitsBeforeRecords(Reader, NumMaterials, sizeof(int32)))
+                return false;
+
+            FInventoryArchetype& Archetype = Archetypes.AddDefaulted_GetRef();
+
+            // Item classes are normally resident already, this only blocks for ones nothing else references
+            Archetype.WorldObjectReference = TSoftClassPtr<AActor>(Strings[ClassString]).LoadSynchronous();
+            Archetype.StaticMesh = TSoftObjectPtr<UStaticMesh>(Strings[MeshString]);
+
+            Archetype.StoredMaterials.Reserve(NumMaterials);
+            for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; ++MaterialIndex)
+            {
+                int32 MaterialString = INDEX_NONE;
+                Reader << MaterialString;
+
+                if (!Strings.IsValidIndex(MaterialString))
+                    return false;
+
+                Archetype.StoredMaterials.Add(TSoftObjectPtr<UMaterialInterface>(Strings[MaterialString]));
+            }
+        }
+
+        return !Reader.IsError();
+    }
+
+    // Whether Count entries of at least EntrySize bytes each fit between the read position and the records
+    bool FitsBeforeRecords(FMemoryReaderView& Reader, int32 Count, int64 EntrySize) const
+    {
+        return !Reader.IsError() && int64(Count) * EntrySize <= RecordsOffset - Reader.Tell();
+    }
+
+    // Reads a serialized FString after checking its length prefix against the bytes left before the records
+    // (negative lengths are UTF-16, two bytes per character)
+    bool ReadString(FMemoryReaderView& Reader, FString& OutString) const
+    {
+        const int64 LengthPosition = Reader.Tell();
+
+        int32 SaveNum = 0;
+        Reader << SaveNum;
+        if (Reader.IsError() || SaveNum == MIN_int32)
+            return false;
+
+        const int64 NumBytes = SaveNum >= 0 ? int64(SaveNum) : -int64(SaveNum) * 2;
+        if (NumBytes > RecordsOffset - Reader.Tell())
+            return false;
+
+        Reader.Seek(LengthPosition);
+        Reader << OutString;
+        return !Reader.IsError();
+    }
+
+    TUniquePtr<IMappedFileHandle> MappedFile;
+
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+
+    // Only used when the platform can't memory map
+    TArray<uint8> FallbackBytes;
+
+    TArrayView<const uint8> Data;
+
+    TArray<FInventoryArchetype> Archetypes;
+
+    int32 NumSlots = 0;
+
+    int32 NumRecords = 0;
+
+    int64 RecordsOffset = 0;
+};
@@ -0,0 +1,240 @@
+#include "InventoryTestHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/FileManager.h"
+
+namespace
+{
+    FString GetSnapshotTestPath(const TCHAR* Name)
+    {
+        return FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("Inventory"), FString(Name) + TEXT(".invsnap"));
+    }
+
+    // Cube and sphere mesh actors, as if picked up from the world
+    void AddSyntheticArchetypes(FInventorySnapshotWriter& Writer)
+    {
+        static const TCHAR* const MeshPaths[] =
+        {
+            TEXT("/Engine/BasicShapes/Cube.Cube"),
+            TEXT("/Engine/BasicShapes/Sphere.Sphere"),
+        };
+
+        for (const TCHAR* MeshPath : MeshPaths)
+        {
+            FInventoryArchetype Archetype;
+            Archetype.WorldObjectReference = AStaticMeshActor::StaticClass();
+            Archetype.StaticMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(MeshPath));
+            Writer.AddArchetype(Archetype);
+        }
+    }
+
+    FInventorySnapshotRecord MakeRecord(int32 SlotIndex, int32 Archetype, int32 ItemId, int32 Quantity)
+    {
+        FInventorySnapshotRecord Record;
+        Record.SlotIndex = SlotIndex;
+        Record.Archetype = Archetype;
+        Record.ItemId = ItemId;
+        Record.Quantity = Quantity;
+        return Record;
+    }
+
+    // A snapshot with NumItems occupied slots, packed from slot 0 and alternating between the two archetypes
+    bool WriteSyntheticSnapshot(const FString& FilePath, int32 NumSlots, int32 NumItems, int32 MaxStackSize)
+    {
+        FInventorySnapshotWriter Writer;
+        Writer.SetNumSlots(NumSlots);
+        AddSyntheticArchetypes(Writer);
+
+        for (int32 ItemIndex = 0; ItemIndex < NumItems; ++ItemIndex)
+            Writer.AddRecord(MakeRecord(ItemIndex, ItemIndex % 2, ItemIndex, 1 + ItemIndex % MaxStackSize));
+
+        TArray<uint8> Bytes;
+        Writer.Encode(Bytes);
+        return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+    }
+
+    TArray<int32> GetSlotQuantities(const UInventory& Inventory, int32 NumSlots)
+    {
+        TArray<int32> Quantities;
+        Quantities.Reserve(NumSlots);
+        for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+            Quantities.Add(Inventory.GetItemQuantity(SlotIndex));
+
+        return Quantities;
+    }
+}
+
+// Saving then loading has to give back the same slots, stacks and archetypes, and corrupt files have to be refused
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySnapshotRoundTripTest, "Inventory.Snapshot.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInventorySnapshotRoundTripTest::RunTest(const FString& Parameters)
+{
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+    Fixture.SetGridSize(4, 4);
+    const int32 NumSlots = 16;
+
+    // Stacks of several sizes, then a gap in the middle
+    TArray<TSoftObjectPtr<UStaticMesh>> Meshes;
+    for (int32 PickupIndex = 0; PickupIndex < 27; ++PickupIndex)
+    {
+        AStaticMeshActor* ItemActor = Fixture.SpawnItemActor(PickupIndex % 5, FVector(PickupIndex * 100.0f, 0.0f, 0.0f));
+        if (!ItemActor)
+            continue;
+
+        Meshes.AddUnique(TSoftObjectPtr<UStaticMesh>(ItemActor->GetStaticMeshComponent()->GetStaticMesh()));
+        Inventory.AddItem(ItemActor);
+    }
+
+    Inventory.RemoveItem(2);
+
+    const TArray<int32> SavedQuantities = GetSlotQuantities(Inventory, NumSlots);
+    TArray<int32> SavedMeshCounts;
+    for (const TSoftObjectPtr<UStaticMesh>& Mesh : Meshes)
+        SavedMeshCounts.Add(Inventory.CountItemsByMesh(Mesh));
+
+    const FString FilePath = GetSnapshotTestPath(TEXT("RoundTrip"));
+    if (!TestTrue(TEXT("Snapshot saved"), Inventory.SaveSnapshot(FilePath).Get()))
+        return false;
+
+    // Resizing empties the inventory, so everything after this comes from the file
+    Fixture.SetGridSize(4, 4);
+    TestTrue(TEXT("Emptied before loading"), Inventory.IsInventoryEmpty());
+
+    TestTrue(TEXT("Snapshot loaded"), Inventory.LoadSnapshot(FilePath));
+    TestTrue(TEXT("Slot quantities survive the round trip"), GetSlotQuantities(Inventory, NumSlots) == SavedQuantities);
+
+    for (int32 MeshIndex = 0; MeshIndex < Meshes.Num(); ++MeshIndex)
+        TestEqual(FString::Printf(TEXT("Items with mesh %s"), *Meshes[MeshIndex].ToString()), Inventory.CountItemsByMesh(Meshes[MeshIndex]), SavedMeshCounts[MeshIndex]);
+
+    // Refused records: a second record for a slot, a stack over the limit, a reused, negative or out of range
+    // item index. Only the first and last records below are valid
+    const int32 MaxStackSize = FInventoryTestAccess::GetMaxStackSize(Inventory);
+    {
+        FInventorySnapshotWriter Writer;
+        Writer.SetNumSlots(NumSlots);
+        AddSyntheticArchetypes(Writer);
+        Writer.AddRecord(MakeRecord(0, 0, 0, 3));
+        Writer.AddRecord(MakeRecord(0, 1, 1, 5));
+        Writer.AddRecord(MakeRecord(1, 1, 2, MaxStackSize * 10));
+        Writer.AddRecord(MakeRecord(2, 1, 0, 1));
+        Writer.AddRecord(MakeRecord(3, 1, -1, 1));
+        Writer.AddRecord(MakeRecord(4, 1, MAX_int32, 1));
+        Writer.AddRecord(MakeRecord(5, 1, 7, MaxStackSize));
+
+        TArray<uint8> Bytes;
+        Writer.Encode(Bytes);
+
+        AddExpectedError(TEXT("refused 5 of 7 records"), EAutomationExpectedErrorFlags::Contains, 1);
+
+        const FString MalformedPath = GetSnapshotTestPath(TEXT("Malformed"));
+        TestTrue(TEXT("Malformed snapshot saved"), FFileHelper::SaveArrayToFile(Bytes, *MalformedPath));
+        TestTrue(TEXT("Malformed snapshot loaded"), Inventory.LoadSnapshot(MalformedPath));
+        TestEqual(TEXT("Occupied slots"), Inventory.GetNumOccupiedSlots(), 2);
+        TestEqual(TEXT("First record of a slot wins"), Inventory.GetItemQuantity(0), 3);
+        TestEqual(TEXT("Oversized stack refused"), Inventory.GetItemQuantity(1), 0);
+        TestEqual(TEXT("Reused item index refused"), Inventory.GetItemQuantity(2), 0);
+        TestEqual(TEXT("Negative item index refused"), Inventory.GetItemQuantity(3), 0);
+        TestEqual(TEXT("Out of range item index refused"), Inventory.GetItemQuantity(4), 0);
+        TestEqual(TEXT("Full stack kept"), Inventory.GetItemQuantity(5), MaxStackSize);
+
+        // Header is Magic, Version, NumSlots, NumStrings, NumArchetypes, NumRecords then the 64 bit records offset,
+        // the first string's length follows right after it
+        auto Patched = [&Bytes](int64 Offset, auto Value)
+        {
+            TArray<uint8> PatchedBytes = Bytes;
+            FMemory::Memcpy(PatchedBytes.GetData() + Offset, &Value, sizeof(Value));
+            return PatchedBytes;
+        };
+
+        int64 RecordsOffset = 0;
+        FMemory::Memcpy(&RecordsOffset, Bytes.GetData() + 6 * sizeof(int32), sizeof(RecordsOffset));
+
+        TArray<uint8> TruncatedBytes = Bytes;
+        TruncatedBytes.SetNum(Bytes.Num() - int32(InventorySnapshot::RecordSize) / 2);
+
+        // Neither synthetic archetype has materials, so the material count of the last one ends right where the records start
+        const TPair<const TCHAR*, TArray<uint8>> CorruptSnapshots[] =
+        {
+            { TEXT("Version 0"), Patched(sizeof(int32), uint32(0)) },
+            { TEXT("Huge string count"), Patched(3 * sizeof(int32), int32(MAX_int32 - 15)) },
+            { TEXT("Huge archetype count"), Patched(4 * sizeof(int32), int32(MAX_int32 - 15)) },
+            { TEXT("Negative records offset"), Patched(6 * sizeof(int32), int64(-1)) },
+            { TEXT("Huge string length"), Patched(6 * sizeof(int32) + sizeof(int64), int32(MAX_int32 - 15)) },
+            { TEXT("Huge material count"), Patched(RecordsOffset - sizeof(int32), int32(MAX_int32 - 15)) },
+            { TEXT("Truncated records"), MoveTemp(TruncatedBytes) },
+        };
+
+#if WITH_EDITOR
+        AddExpectedError(TEXT("Couldn't read inventory snapshot"), EAutomationExpectedErrorFlags::Contains, UE_ARRAY_COUNT(CorruptSnapshots));
+#endif
+
+        const FString CorruptPath = GetSnapshotTestPath(TEXT("Corrupt"));
+        for (const TPair<const TCHAR*, TArray<uint8>>& CorruptSnapshot : CorruptSnapshots)
+        {
+            TestTrue(FString::Printf(TEXT("%s snapshot saved"), CorruptSnapshot.Key), FFileHelper::SaveArrayToFile(CorruptSnapshot.Value, *CorruptPath));
+            TestFalse(FString::Printf(TEXT("%s refused"), CorruptSnapshot.Key), Inventory.LoadSnapshot(CorruptPath));
+        }
+
+        TestEqual(TEXT("Refused loads leave the inventory alone"), Inventory.GetNumOccupiedSlots(), 2);
+    }
+
+    return true;
+}
+
+// LoadSnapshot() cost from a handful of items to a hundred thousand, file mapping, decoding and refresh included
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySnapshotLoadPerfTest, "Inventory.Perf.SnapshotLoad", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventorySnapshotLoadPerfTest::RunTest(const FString& Parameters)
+{
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+    const int32 MaxStackSize = FInventoryTestAccess::GetMaxStackSize(Inventory);
+
+    FInventoryPerfReport Report(TEXT("InventorySnapshotLoad"));
+
+    struct FLoadSize
+    {
+        int32 NumItems;
+        int32 GridSide;
+        int32 Iterations;
+    };
+
+    // Grids just big enough for every item
+    const FLoadSize LoadSizes[] = { { 12, 4, 64 }, { 1000, 32, 32 }, { 100000, 317, 8 } };
+
+    for (const FLoadSize& LoadSize : LoadSizes)
+    {
+        const int32 NumSlots = LoadSize.GridSide * LoadSize.GridSide;
+        Fixture.SetGridSize(LoadSize.GridSide, LoadSize.GridSide);
+
+        const FString FilePath = GetSnapshotTestPath(*FString::Printf(TEXT("Load%d"), LoadSize.NumItems));
+        if (!TestTrue(TEXT("Snapshot written"), WriteSyntheticSnapshot(FilePath, NumSlots, LoadSize.NumItems, MaxStackSize)))
+            return false;
+
+        bool bAllLoaded = true;
+        const FInventoryOperationTiming LoadTiming = TimeInventoryOperation(LoadSize.Iterations,
+            [](int32) {},
+            [&](int32) { bAllLoaded &= Inventory.LoadSnapshot(FilePath); });
+
+        TestTrue(FString::Printf(TEXT("Every load of %d items succeeded"), LoadSize.NumItems), bAllLoaded);
+        TestEqual(FString::Printf(TEXT("Occupied slots after loading %d items"), LoadSize.NumItems), Inventory.GetNumOccupiedSlots(), LoadSize.NumItems);
+
+        TArray<TPair<FString, double>> Values = LoadTiming.ToValues(NumSlots);
+        Values.Emplace(TEXT("NumItems"), LoadSize.NumItems);
+        Values.Emplace(TEXT("FileBytes"), double(IFileManager::Get().FileSize(*FilePath)));
+        Values.Emplace(TEXT("LastLoadMicroseconds"), Inventory.GetLastSnapshotLoadSeconds() * 1000000.0);
+        Report.AddRow(FString::Printf(TEXT("Load %d items"), LoadSize.NumItems), MoveTemp(Values));
+    }
+
+    return Report.Write(*this);
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// Inventory stats ("stat Inventory") and the "Inventory" Insights trace channel, compiled out in shipping builds
+#define INVENTORY_STATS_ENABLED (!UE_BUILD_SHIPPING)
+
+#if INVENTORY_STATS_ENABLED
+
+DECLARE_STATS_GROUP(TEXT("Inventory"), STATGROUP_Inventory, STATCAT_Advanced);
+
+// ************* Cycle counters *************
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AddItem"), STAT_InventoryAddItem, STATGROUP_Inventory, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshInventory"), STAT_InventoryRefresh, STATGROUP_Inventory, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CreateItemIcon"), STAT_InventoryCreateItemIcon, STATGROUP_Inventory, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindHoveredSlot"), STAT_InventoryFindHoveredSlot, STATGROUP_Inventory, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("InternallyRearrangeItems"), STAT_InventoryRearrange, STATGROUP_Inventory, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("DropSpawn"), STAT_InventoryDropSpawn, STATGROUP_Inventory, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GridPaint"), STAT_InventoryGridPaint, STATGROUP_Inventory, );
+
+// ************* Counters *************
+
+// Slots rebuilt this frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Slots Rebuilt"), STAT_InventorySlotsRebuilt, STATGROUP_Inventory, );
+
+// Draw elements painted by leaf grids this frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Grid Draw Elements"), STAT_InventoryGridDrawElements, STATGROUP_Inventory, );
+
+// Totals since startup
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Widgets Created"), STAT_InventoryWidgetsCreated, STATGROUP_Inventory, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Synchronous Asset Loads"), STAT_InventorySyncAssetLoads, STATGROUP_Inventory, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Actors Spawned"), STAT_InventoryActorsSpawned, STATGROUP_Inventory, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Actors Destroyed"), STAT_InventoryActorsDestroyed, STATGROUP_Inventory, );
+
+UE_TRACE_CHANNEL_EXTERN(InventoryChannel);
+
+// Shows up both in "stat Inventory" and as a CPU event on the Inventory trace channel
+#define INVENTORY_SCOPE_CYCLE_COUNTER(Stat) \
+    SCOPE_CYCLE_COUNTER(Stat); \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, InventoryChannel)
+
+#define INVENTORY_INC_COUNTER(Stat) INC_DWORD_STAT(Stat)
+#define INVENTORY_INC_COUNTER_BY(Stat, Amount) INC_DWORD_STAT_BY(Stat, Amount)
+
+#else
+
+#define INVENTORY_SCOPE_CYCLE_COUNTER(Stat)
+#define INVENTORY_INC_COUNTER(Stat)
+#define INVENTORY_INC_COUNTER_BY(Stat, Amount)
+
+#endif
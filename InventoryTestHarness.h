@@ -0,0 +1,639 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Inventory.h"
+#include "InventoryReplicationComponent.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/App.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Input/HittestGrid.h"
+#include "Rendering/DrawElements.h"
+#include "Widgets/SVirtualWindow.h"
+#include <atomic>
+
+// Test fixtures and measurement helpers shared by the inventory automation tests
+// Every test runs headless (-nullrhi is enough): a game world, an inventory widget painted into a virtual window
+// so its geometry is real, and scripted mouse events fed straight into the widget's handlers
+
+// Private inventory state the tests need, UInventory befriends this
+struct FInventoryTestAccess
+{
+    // Only read when the widget gets initialized, so it has to be set before Initialize()
+    static void SetUseLeafGridRenderer(UInventory& Inventory, bool bUseLeafGridRenderer)
+    {
+        Inventory.bUseLeafGridRenderer = bUseLeafGridRenderer;
+    }
+
+    // Whether the body's invalidation box reuses last frame's draw elements
+    static void SetBodyCaching(UInventory& Inventory, bool bCanCache)
+    {
+        if (Inventory.BackgroundInvalidationBox)
+            Inventory.BackgroundInvalidationBox->SetCanCache(bCanCache);
+    }
+
+    // Rebuilds every slot in view, what scrolling a whole page or resizing costs
+    static void RefreshAllSlots(UInventory& Inventory)
+    {
+        Inventory.MarkAllSlotsDirty();
+        Inventory.RefreshInventory();
+    }
+
+    static int32 GetWidgetAllocationCount(const UInventory& Inventory)
+    {
+        return Inventory.WidgetAllocationCount;
+    }
+
+    static int32 GetNumItemLabels(const UInventory& Inventory)
+    {
+        return Inventory.ItemLabels.Num();
+    }
+
+    static int32 GetMaxStackSize(const UInventory& Inventory)
+    {
+        return Inventory.MaxStackSize;
+    }
+
+    static void SetMaxStackSize(UInventory& Inventory, int32 MaxStackSize)
+    {
+        Inventory.MaxStackSize = MaxStackSize;
+    }
+
+    static int32 GetNumArchetypes(const UInventory& Inventory)
+    {
+        return Inventory.ArchetypeTable.Num();
+    }
+
+    // Puts an inventory in the middle of a drag (or out of it) without any mouse event, for whatever waits on drags
+    static void SetDragging(UInventory& Inventory, bool bIsDragging)
+    {
+        Inventory.DragState = bIsDragging ? EDragState::Dragging : EDragState::None;
+    }
+
+    static FInventoryReplicatedSlotArray& GetReplicatedSlots(UInventoryReplicationComponent& Replication)
+    {
+        return Replication.Slots;
+    }
+
+    static TArray<FInventoryArchetype>& GetReplicatedArchetypes(UInventoryReplicationComponent& Replication)
+    {
+        return Replication.Archetypes;
+    }
+
+    // Absolute center of an item slot in view (slot widget in tree mode, leaf grid cell otherwise)
+    static FVector2D GetSlotCenter(const UInventory& Inventory, int32 SlotIndex)
+    {
+        const int32 WidgetSlotIndex = Inventory.ItemSlotToWidgetSlot(SlotIndex);
+        if (WidgetSlotIndex == INDEX_NONE)
+            return FVector2D(-1.0f, -1.0f);
+
+        if (Inventory.LeafGrid)
+        {
+            // SInventoryGrid's default slot size and padding
+            constexpr float LeafSlotPitch = 100.0f + 2.0f * 7.0f;
+            const FVector2D CellCenter(((WidgetSlotIndex % Inventory.MaxColumns) + 0.5f) * LeafSlotPitch, ((WidgetSlotIndex / Inventory.MaxColumns) + 0.5f) * LeafSlotPitch);
+            return Inventory.LeafGrid->GetCachedGeometry().LocalToAbsolute(CellCenter);
+        }
+
+        if (!Inventory.Slots.IsValidIndex(WidgetSlotIndex) || !Inventory.Slots[WidgetSlotIndex])
+            return FVector2D(-1.0f, -1.0f);
+
+        return Inventory.Slots[WidgetSlotIndex]->GetCachedGeometry().GetAbsolutePositionAtCoordinates(FVector2D(0.5f, 0.5f));
+    }
+};
+
+// Counts the heap allocations the game thread makes while enabled by sitting in front of GMalloc
+// Installed once and never removed, so threads that read GMalloc just before a test ends never call into a dead object
+class FInventoryCountingMalloc final : public FMalloc
+{
+public:
+    static FInventoryCountingMalloc& Get()
+    {
+        static FInventoryCountingMalloc* Instance = []()
+        {
+            FInventoryCountingMalloc* CountingMalloc = new FInventoryCountingMalloc(GMalloc);
+            GMalloc = CountingMalloc;
+            return CountingMalloc;
+        }();
+        return *Instance;
+    }
+
+    // Starts counting the calling thread's allocations from zero
+    void Begin()
+    {
+        CountedThreadId.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_relaxed);
+        NumAllocations.store(0, std::memory_order_relaxed);
+        bCounting.store(true, std::memory_order_release);
+    }
+
+    // Stops counting, returns how many allocations were made since Begin()
+    int32 End()
+    {
+        bCounting.store(false, std::memory_order_release);
+        return NumAllocations.load(std::memory_order_relaxed);
+    }
+
+    // Whether GMalloc still routes through this proxy (something else replacing GMalloc breaks counting)
+    bool IsInstalled() const
+    {
+        return GMalloc == this;
+    }
+
+    virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+    {
+        NoteAllocation();
+        return InnerMalloc->Malloc(Count, Alignment);
+    }
+
+    virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+    {
+        // Shrinking to zero is a free
+        if (Count > 0)
+            NoteAllocation();
+        return InnerMalloc->Realloc(Original, Count, Alignment);
+    }
+
+    virtual void Free(void* Original) override
+    {
+        InnerMalloc->Free(Original);
+    }
+
+    virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+    {
+        return InnerMalloc->QuantizeSize(Count, Alignment);
+    }
+
+    virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+    {
+        return InnerMalloc->GetAllocationSize(Original, SizeOut);
+    }
+
+    virtual void Trim(bool bTrimThreadCaches) override
+    {
+        InnerMalloc->Trim(bTrimThreadCaches);
+    }
+
+    virtual void SetupTLSCachesOnCurrentThread() override
+    {
+        InnerMalloc->SetupTLSCachesOnCurrentThread();
+    }
+
+    virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+    {
+        InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+    }
+
+    virtual void UpdateStats() override
+    {
+        InnerMalloc->UpdateStats();
+    }
+
+    virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+    {
+        InnerMalloc->GetAllocatorStats(OutStats);
+    }
+
+    virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+    {
+        InnerMalloc->DumpAllocatorStats(Ar);
+    }
+
+    virtual bool ValidateHeap() override
+    {
+        return InnerMalloc->ValidateHeap();
+    }
+
+    virtual bool IsInternallyThreadSafe() const override
+    {
+        return InnerMalloc->IsInternallyThreadSafe();
+    }
+
+    virtual const TCHAR* GetDescriptiveName() override
+    {
+        return InnerMalloc->GetDescriptiveName();
+    }
+
+private:
+    explicit FInventoryCountingMalloc(FMalloc* InInnerMalloc)
+        : InnerMalloc(InInnerMalloc)
+    {
+    }
+
+    void NoteAllocation()
+    {
+        if (bCounting.load(std::memory_order_acquire) && FPlatformTLS::GetCurrentThreadId() == CountedThreadId.load(std::memory_order_relaxed))
+            NumAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FMalloc* InnerMalloc;
+
+    std::atomic<bool> bCounting{ false };
+
+    std::atomic<uint32> CountedThreadId{ 0 };
+
+    std::atomic<int32> NumAllocations{ 0 };
+};
+
+// Counts the game thread's heap allocations for as long as it's in scope
+class FInventoryAllocationScope
+{
+public:
+    FInventoryAllocationScope()
+        : CountingMalloc(FInventoryCountingMalloc::Get())
+    {
+        CountingMalloc.Begin();
+    }
+
+    ~FInventoryAllocationScope()
+    {
+        if (!bHasEnded)
+            CountingMalloc.End();
+    }
+
+    // Stops counting and returns the number of allocations made in scope
+    int32 End()
+    {
+        bHasEnded = true;
+        return CountingMalloc.End();
+    }
+
+private:
+    FInventoryCountingMalloc& CountingMalloc;
+
+    bool bHasEnded = false;
+};
+
+// Rows of one perf test, written as CSV and JSON to Saved/Profiling/Inventory (same layout as Inventory.PerfReport)
+class FInventoryPerfReport
+{
+public:
+    explicit FInventoryPerfReport(const FString& InName)
+        : Name(InName)
+    {
+    }
+
+    // Every row should have the same columns, in the same order
+    void AddRow(const FString& Label, TArray<TPair<FString, double>> Values)
+    {
+        Rows.Emplace(Label, MoveTemp(Values));
+    }
+
+    // Writes <Name>.csv and <Name>.json, returns false when either couldn't be written
+    bool Write(FAutomationTestBase& Test) const
+    {
+        FString Csv;
+        FString Json = TEXT("[\n");
+
+        for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+        {
+            const TPair<FString, TArray<TPair<FString, double>>>& Row = Rows[RowIndex];
+
+            if (RowIndex == 0)
+            {
+                Csv += TEXT("Operation");
+                for (const TPair<FString, double>& Value : Row.Value)
+                    Csv += TEXT(",") + Value.Key;
+                Csv += TEXT("\n");
+            }
+
+            Csv += Row.Key;
+            for (const TPair<FString, double>& Value : Row.Value)
+                Csv += FString::Printf(TEXT(",%g"), Value.Value);
+            Csv += TEXT("\n");
+
+            Json += FString::Printf(TEXT("  { \"Operation\": \"%s\""), *Row.Key);
+            for (const TPair<FString, double>& Value : Row.Value)
+                Json += FString::Printf(TEXT(", \"%s\": %g"), *Value.Key, Value.Value);
+            Json += RowIndex + 1 < Rows.Num() ? TEXT(" },\n") : TEXT(" }\n");
+        }
+
+        Json += TEXT("]\n");
+
+        const FString BasePath = FPaths::ProfilingDir() / TEXT("Inventory") / Name;
+        const bool bWritten = FFileHelper::SaveStringToFile(Csv, *(BasePath + TEXT(".csv"))) && FFileHelper::SaveStringToFile(Json, *(BasePath + TEXT(".json")));
+
+        if (bWritten)
+            Test.AddInfo(FString::Printf(TEXT("Perf report written to %s.csv and .json"), *BasePath));
+        else
+            Test.AddError(FString::Printf(TEXT("Couldn't write perf report %s"), *BasePath));
+
+        return bWritten;
+    }
+
+private:
+    FString Name;
+
+    TArray<TPair<FString, TArray<TPair<FString, double>>>> Rows;
+};
+
+// Timing and heap allocations of repeating one operation
+struct FInventoryOperationTiming
+{
+    int32 Iterations = 0;
+
+    double TotalSeconds = 0.0;
+
+    double MaxSeconds = 0.0;
+
+    int32 Allocations = 0;
+
+    double GetAverageMicroseconds() const
+    {
+        return Iterations > 0 ? TotalSeconds * 1000000.0 / Iterations : 0.0;
+    }
+
+    double GetAllocationsPerIteration() const
+    {
+        return Iterations > 0 ? double(Allocations) / Iterations : 0.0;
+    }
+
+    // Report columns, NumSlots first
+    TArray<TPair<FString, double>> ToValues(int32 NumSlots) const
+    {
+        TArray<TPair<FString, double>> Values;
+        Values.Emplace(TEXT("NumSlots"), NumSlots);
+        Values.Emplace(TEXT("Iterations"), Iterations);
+        Values.Emplace(TEXT("AverageMicroseconds"), GetAverageMicroseconds());
+        Values.Emplace(TEXT("MaxMicroseconds"), MaxSeconds * 1000000.0);
+        Values.Emplace(TEXT("AllocationsPerIteration"), GetAllocationsPerIteration());
+        return Values;
+    }
+};
+
+// Runs Setup (untimed) then Operation, Iterations times
+template<typename SetupType, typename OperationType>
+FInventoryOperationTiming TimeInventoryOperation(int32 Iterations, SetupType&& Setup, OperationType&& Operation)
+{
+    FInventoryOperationTiming Timing;
+    Timing.Iterations = Iterations;
+
+    for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        Setup(Iteration);
+
+        FInventoryAllocationScope AllocationScope;
+        const double StartSeconds = FPlatformTime::Seconds();
+
+        Operation(Iteration);
+
+        const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+        Timing.Allocations += AllocationScope.End();
+        Timing.TotalSeconds += ElapsedSeconds;
+        Timing.MaxSeconds = FMath::Max(Timing.MaxSeconds, ElapsedSeconds);
+    }
+
+    return Timing;
+}
+
+// Press at one position, move past the drag threshold, move onto another position and release
+// NativeTick() runs after every event, like one frame per event. Events are built up front so running
+// the script allocates nothing by itself
+struct FInventoryScriptedDrag
+{
+    FInventoryScriptedDrag(const FVector2D& From, const FVector2D& To)
+        : Press(MakeMouseEvent(From, From, true))
+        , Nudge(MakeMouseEvent(From + FVector2D(10.0f, 0.0f), From, true))
+        , Arrive(MakeMouseEvent(To, From + FVector2D(10.0f, 0.0f), true))
+        , Release(MakeMouseEvent(To, To, false))
+    {
+    }
+
+    void Run(UInventory& Inventory, float DeltaTime = 1.0f / 60.0f) const
+    {
+        const FGeometry Geometry = Inventory.GetCachedGeometry();
+
+        Inventory.NativeOnMouseButtonDown(Geometry, Press);
+        Inventory.NativeTick(Geometry, DeltaTime);
+        Inventory.NativeOnMouseMove(Geometry, Nudge);
+        Inventory.NativeTick(Geometry, DeltaTime);
+        Inventory.NativeOnMouseMove(Geometry, Arrive);
+        Inventory.NativeTick(Geometry, DeltaTime);
+        Inventory.NativeOnMouseButtonUp(Geometry, Release);
+        Inventory.NativeTick(Geometry, DeltaTime);
+    }
+
+    // Left button event, pressed button sets outlive the event (some engine versions only reference them)
+    static FPointerEvent MakeMouseEvent(const FVector2D& Position, const FVector2D& LastPosition, bool bIsLeftButtonDown)
+    {
+        static const TSet<FKey> NoButtons;
+        static const TSet<FKey> LeftButton = { EKeys::LeftMouseButton };
+
+        return FPointerEvent(0, Position, LastPosition, bIsLeftButtonDown ? LeftButton : NoButtons, EKeys::LeftMouseButton, 0.0f, FModifierKeysState());
+    }
+
+    FPointerEvent Press;
+    FPointerEvent Nudge;
+    FPointerEvent Arrive;
+    FPointerEvent Release;
+};
+
+// A game world holding one inventory widget painted into a virtual window
+class FInventoryTestFixture
+{
+public:
+    static constexpr float WindowWidth = 1920.0f;
+    static constexpr float WindowHeight = 1080.0f;
+
+    explicit FInventoryTestFixture(bool bUseLeafGridRenderer = false)
+    {
+        // Widgets measure text through the Slate renderer, a null RHI renderer does that fine but a commandlet has none
+        if (!GEngine || !FSlateApplication::IsInitialized())
+            return;
+
+        World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("InventoryTestWorld"));
+        FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+        WorldContext.SetCurrentWorld(World);
+        World->InitializeActorsForPlay(FURL());
+        World->BeginPlay();
+
+        Inventory = NewObject<UInventory>(World, NAME_None, RF_Transient);
+        Inventory->AddToRoot();
+        FInventoryTestAccess::SetUseLeafGridRenderer(*Inventory, bUseLeafGridRenderer);
+        Inventory->Initialize();
+
+        Window = SNew(SVirtualWindow).Size(FVector2D(WindowWidth, WindowHeight));
+        Window->SetContent(Inventory->TakeWidget());
+
+        Paint();
+    }
+
+    ~FInventoryTestFixture()
+    {
+        for (int32 OtherIndex = 0; OtherIndex < OtherInventories.Num(); ++OtherIndex)
+        {
+            OtherWidgets[OtherIndex].Reset();
+            OtherInventories[OtherIndex]->ReleaseSlateResources(true);
+            OtherInventories[OtherIndex]->RemoveFromRoot();
+        }
+
+        // Dropping the Slate widget destructs the inventory (pooled and pending actors go with it)
+        if (Window.IsValid())
+            Window->SetContent(SNullWidget::NullWidget);
+
+        if (Inventory)
+        {
+            Inventory->ReleaseSlateResources(true);
+            Inventory->RemoveFromRoot();
+        }
+
+        if (World)
+        {
+            GEngine->DestroyWorldContext(World);
+            World->DestroyWorld(false);
+        }
+    }
+
+    FInventoryTestFixture(const FInventoryTestFixture&) = delete;
+    FInventoryTestFixture& operator=(const FInventoryTestFixture&) = delete;
+
+    // False without a Slate application (commandlets)
+    bool IsValid() const
+    {
+        return World && Inventory && Window.IsValid();
+    }
+
+    // Like IsValid(), but reports the missing Slate application as an error of Test, tests return false right after
+    bool IsValidFor(FAutomationTestBase& Test) const
+    {
+        if (IsValid())
+            return true;
+
+        Test.AddError(TEXT("Needs a Slate application, run it from the editor or a game started with -nullrhi"));
+        return false;
+    }
+
+    UWorld* GetWorld() const
+    {
+        return World;
+    }
+
+    UInventory& GetInventory() const
+    {
+        check(Inventory);
+        return *Inventory;
+    }
+
+    // Resizes the grid and lays the new slots out so they can be hit-tested
+    void SetGridSize(int32 NumRows, int32 NumColumns)
+    {
+        Inventory->SetGridSize(NumRows, NumColumns);
+        Paint();
+    }
+
+    // Lays out and paints the whole window, returns the number of draw elements this paint emitted
+    // (elements replayed from an invalidation box's cache aren't emitted again, turn caching off to count everything)
+    int32 Paint(float DeltaTime = 1.0f / 60.0f, double* OutPaintSeconds = nullptr)
+    {
+        const FVector2D WindowSize(WindowWidth, WindowHeight);
+
+        Window->SlatePrepass(FSlateApplication::Get().GetApplicationScale());
+
+        FHittestGrid& HittestGrid = Window->GetHittestGrid();
+        HittestGrid.SetHittestArea(FVector2D::ZeroVector, WindowSize);
+        HittestGrid.Clear();
+
+        FSlateWindowElementList ElementList(Window);
+        const FGeometry WindowGeometry = FGeometry::MakeRoot(WindowSize, FSlateLayoutTransform());
+        const FPaintArgs PaintArgs(Window.Get(), HittestGrid, FVector2D::ZeroVector, FApp::GetCurrentTime(), DeltaTime);
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        Window->Paint(PaintArgs, WindowGeometry, FSlateRect(FVector2D::ZeroVector, WindowSize), ElementList, 0, FWidgetStyle(), true);
+        if (OutPaintSeconds)
+            *OutPaintSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+        int32 NumDrawElements = 0;
+        VisitTupleElements([&NumDrawElements](const auto& Elements) { NumDrawElements += Elements.Num(); }, ElementList.GetUncachedDrawElements());
+        return NumDrawElements;
+    }
+
+    // Number of Slate widgets under the window
+    int32 CountSlateWidgets() const
+    {
+        return CountSlateWidgets(Window.ToSharedRef()) - 1;
+    }
+
+    FVector2D GetSlotCenter(int32 SlotIndex) const
+    {
+        return FInventoryTestAccess::GetSlotCenter(*Inventory, SlotIndex);
+    }
+
+    // Another inventory in the same world (a chest or stash), built but never painted, destroyed with the fixture
+    UInventory& AddOtherInventory(int32 NumRows, int32 NumColumns)
+    {
+        UInventory* OtherInventory = NewObject<UInventory>(World, NAME_None, RF_Transient);
+        OtherInventory->AddToRoot();
+        OtherInventory->Initialize();
+        OtherWidgets.Add(OtherInventory->TakeWidget());
+        OtherInventory->SetGridSize(NumRows, NumColumns);
+
+        OtherInventories.Add(OtherInventory);
+        return *OtherInventory;
+    }
+
+    // A point of the window nowhere near the inventory (anchored to the top right corner)
+    FVector2D GetOutsidePosition() const
+    {
+        return FVector2D(20.0f, WindowHeight - 20.0f);
+    }
+
+    // Spawns a pickup, variants with different meshes never stack together (the mesh repeats every 5 variants, so 0 and 5 do)
+    AStaticMeshActor* SpawnItemActor(int32 Variant, const FVector& Location = FVector::ZeroVector) const
+    {
+        static const TCHAR* const MeshPaths[] =
+        {
+            TEXT("/Engine/BasicShapes/Cube.Cube"),
+            TEXT("/Engine/BasicShapes/Sphere.Sphere"),
+            TEXT("/Engine/BasicShapes/Cylinder.Cylinder"),
+            TEXT("/Engine/BasicShapes/Cone.Cone"),
+            TEXT("/Engine/BasicShapes/Plane.Plane"),
+        };
+
+        FActorSpawnParameters SpawnParameters;
+        SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+        AStaticMeshActor* ItemActor = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, SpawnParameters);
+        if (!ItemActor)
+            return nullptr;
+
+        UStaticMeshComponent* MeshComponent = ItemActor->GetStaticMeshComponent();
+        MeshComponent->SetMobility(EComponentMobility::Movable);
+        MeshComponent->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, MeshPaths[Variant % UE_ARRAY_COUNT(MeshPaths)]));
+
+        return ItemActor;
+    }
+
+private:
+    static int32 CountSlateWidgets(const TSharedRef<SWidget>& Widget)
+    {
+        int32 NumWidgets = 1;
+
+        FChildren* Children = Widget->GetChildren();
+        for (int32 ChildIndex = 0; Children && ChildIndex < Children->Num(); ++ChildIndex)
+            NumWidgets += CountSlateWidgets(Children->GetChildAt(ChildIndex));
+
+        return NumWidgets;
+    }
+
+    UWorld* World = nullptr;
+
+    UInventory* Inventory = nullptr;
+
+    TSharedPtr<SVirtualWindow> Window;
+
+    TArray<UInventory*> OtherInventories;
+
+    TArray<TSharedPtr<SWidget>> OtherWidgets;
+};
+
+#endif
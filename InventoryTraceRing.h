@@ -0,0 +1,164 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include <atomic>
+
+// Hot-path diagnostics ring buffer, compiled out in shipping builds
+#define INVENTORY_TRACE_RING_ENABLED (!UE_BUILD_SHIPPING)
+
+enum class EInventoryTraceEventType : uint8
+{
+    None,
+    HoverChanged,       // Slot = newly hovered slot, OtherSlot = previously hovered slot
+    DragPressed,        // Slot = pressed slot
+    DragStarted,        // Slot = origin slot
+    Swapped,            // Slot = origin slot, OtherSlot = slot swapped with
+    Merged,             // Slot = source stack, OtherSlot = target stack
+    Split,              // Slot = split stack, OtherSlot = slot the split off half went to
+    Dropped,            // Slot = origin slot, OtherSlot = slot released over
+    DroppedToWorld,     // Slot = origin slot
+    Transferred,        // Slot = source slot, OtherSlot = slot written last in the destination inventory
+    AddRejected,        // Inventory full
+    RearrangeRejected,  // Rearranging requested outside of a drag or without a valid hovered slot
+};
+
+inline const TCHAR* LexToString(EInventoryTraceEventType Type)
+{
+    switch (Type)
+    {
+        case EInventoryTraceEventType::HoverChanged:      return TEXT("HoverChanged");
+        case EInventoryTraceEventType::DragPressed:       return TEXT("DragPressed");
+        case EInventoryTraceEventType::DragStarted:       return TEXT("DragStarted");
+        case EInventoryTraceEventType::Swapped:           return TEXT("Swapped");
+        case EInventoryTraceEventType::Merged:            return TEXT("Merged");
+        case EInventoryTraceEventType::Split:             return TEXT("Split");
+        case EInventoryTraceEventType::Dropped:           return TEXT("Dropped");
+        case EInventoryTraceEventType::DroppedToWorld:    return TEXT("DroppedToWorld");
+        case EInventoryTraceEventType::Transferred:       return TEXT("Transferred");
+        case EInventoryTraceEventType::AddRejected:       return TEXT("AddRejected");
+        case EInventoryTraceEventType::RearrangeRejected: return TEXT("RearrangeRejected");
+        default:                                          return TEXT("None");
+    }
+}
+
+// One structured event, plain data so recording never formats or allocates
+struct FInventoryTraceEvent
+{
+    uint64 Cycles = 0;
+
+    // UObject unique id of the inventory that recorded the event
+    uint32 InventoryId = 0;
+
+    int32 SlotIndex = INDEX_NONE;
+
+    int32 OtherSlotIndex = INDEX_NONE;
+
+    int32 ItemId = INDEX_NONE;
+
+    EInventoryTraceEventType Type = EInventoryTraceEventType::None;
+
+    // Drag state right after the event
+    uint8 DragState = 0;
+};
+
+// Fixed size lock-free ring of the most recent events shared by every inventory, oldest events get overwritten
+// Writers claim a sequence number with a single atomic add, then lock their entry seqlock style: the entry's
+// sequence goes odd while the payload is written and even once it's published. A writer that finds its entry
+// already locked or holding a newer event (it got lapped by a whole ring while stalled) drops its event instead
+// of racing the other writer. The payload itself lives in atomic words, so readers never race a writer either,
+// they only keep a copy whose sequence didn't change while it was read
+class FInventoryTraceRing
+{
+public:
+    static constexpr uint32 Capacity = 4096;
+
+    static FInventoryTraceRing& Get()
+    {
+        static FInventoryTraceRing Ring;
+        return Ring;
+    }
+
+    void Record(const FInventoryTraceEvent& Event)
+    {
+        const uint64 Sequence = NextSequence.fetch_add(1, std::memory_order_relaxed);
+        FEntry& Entry = Entries[Sequence & (Capacity - 1)];
+
+        const uint64 PublishedState = GetPublishedState(Sequence);
+        uint64 CurrentState = Entry.State.load(std::memory_order_relaxed);
+
+        // Locked by another writer, or that writer's newer event is already in place
+        if ((CurrentState & 1) != 0 || CurrentState >= PublishedState)
+            return;
+
+        if (!Entry.State.compare_exchange_strong(CurrentState, PublishedState - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return;
+
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Entry.Words[0].store(FPlatformTime::Cycles64(), std::memory_order_relaxed);
+        Entry.Words[1].store(uint64(Event.InventoryId) | (uint64(uint32(Event.SlotIndex)) << 32), std::memory_order_relaxed);
+        Entry.Words[2].store(uint64(uint32(Event.OtherSlotIndex)) | (uint64(uint32(Event.ItemId)) << 32), std::memory_order_relaxed);
+        Entry.Words[3].store(uint64(Event.Type) | (uint64(Event.DragState) << 8), std::memory_order_relaxed);
+
+        Entry.State.store(PublishedState, std::memory_order_release);
+    }
+
+    // Copies the recorded events out, oldest first
+    void Snapshot(TArray<FInventoryTraceEvent>& OutEvents) const
+    {
+        const uint64 EndSequence = NextSequence.load(std::memory_order_acquire);
+        const uint64 BeginSequence = EndSequence > Capacity ? EndSequence - Capacity : 0;
+
+        OutEvents.Reset(int32(EndSequence - BeginSequence));
+        for (uint64 Sequence = BeginSequence; Sequence < EndSequence; ++Sequence)
+        {
+            const FEntry& Entry = Entries[Sequence & (Capacity - 1)];
+            const uint64 PublishedState = GetPublishedState(Sequence);
+            if (Entry.State.load(std::memory_order_acquire) != PublishedState)
+                continue;
+
+            uint64 Words[NumWords];
+            for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+                Words[WordIndex] = Entry.Words[WordIndex].load(std::memory_order_relaxed);
+
+            // Rewritten while being copied, the copy may mix two events
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (Entry.State.load(std::memory_order_relaxed) != PublishedState)
+                continue;
+
+            FInventoryTraceEvent& Event = OutEvents.AddDefaulted_GetRef();
+            Event.Cycles = Words[0];
+            Event.InventoryId = uint32(Words[1]);
+            Event.SlotIndex = int32(uint32(Words[1] >> 32));
+            Event.OtherSlotIndex = int32(uint32(Words[2]));
+            Event.ItemId = int32(uint32(Words[2] >> 32));
+            Event.Type = EInventoryTraceEventType(uint8(Words[3]));
+            Event.DragState = uint8(Words[3] >> 8);
+        }
+    }
+
+private:
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+    // Cycles, inventory id and slot, other slot and item id, type and drag state
+    static constexpr int32 NumWords = 4;
+
+    // Even and never 0, the odd value right below it means the event is being written
+    static uint64 GetPublishedState(uint64 Sequence)
+    {
+        return (Sequence + 1) * 2;
+    }
+
+    struct FEntry
+    {
+        // Published state of the event held, odd while being written, 0 while empty
+        std::atomic<uint64> State { 0 };
+
+        std::atomic<uint64> Words[NumWords] = {};
+    };
+
+    std::atomic<uint64> NextSequence { 0 };
+
+    FEntry Entries[Capacity];
+};
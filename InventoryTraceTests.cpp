@@ -0,0 +1,90 @@
+#include "InventoryTestHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/Async.h"
+
+// Writers racing each other and a reader must never produce a torn event: every field of an event written here is
+// derived from its slot index, so any mix of two events shows up as a mismatch
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryTraceRingConcurrencyTest, "Inventory.Trace.Concurrency", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInventoryTraceRingConcurrencyTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumProducers = 8;
+    constexpr int32 EventsPerProducer = 50000;
+
+    // Marks the events of this test apart from whatever else gets traced meanwhile
+    constexpr uint32 TestInventoryId = 0xFEED0000;
+
+    FInventoryTraceRing& Ring = FInventoryTraceRing::Get();
+
+    TArray<TFuture<void>> Producers;
+    for (int32 ProducerIndex = 0; ProducerIndex < NumProducers; ++ProducerIndex)
+    {
+        Producers.Add(Async(EAsyncExecution::Thread, [&Ring, ProducerIndex]()
+        {
+            for (int32 EventIndex = 0; EventIndex < EventsPerProducer; ++EventIndex)
+            {
+                FInventoryTraceEvent Event;
+                Event.InventoryId = TestInventoryId | uint32(ProducerIndex);
+                Event.SlotIndex = ProducerIndex * EventsPerProducer + EventIndex;
+                Event.OtherSlotIndex = ~Event.SlotIndex;
+                Event.ItemId = Event.SlotIndex ^ 0x5A5A5A5A;
+                Event.Type = EInventoryTraceEventType::Swapped;
+                Event.DragState = uint8(Event.SlotIndex);
+                Ring.Record(Event);
+            }
+        }));
+    }
+
+    auto AreProducersDone = [&Producers]()
+    {
+        for (const TFuture<void>& Producer : Producers)
+        {
+            if (!Producer.IsReady())
+                return false;
+        }
+
+        return true;
+    };
+
+    int32 NumSnapshots = 0;
+    int32 NumCheckedEvents = 0;
+    int32 NumTornEvents = 0;
+
+    TArray<FInventoryTraceEvent> Events;
+    bool bLastSnapshot = false;
+    while (!bLastSnapshot)
+    {
+        // One more pass once every producer finished, so the settled ring gets checked too
+        bLastSnapshot = AreProducersDone();
+
+        Ring.Snapshot(Events);
+        ++NumSnapshots;
+
+        for (const FInventoryTraceEvent& Event : Events)
+        {
+            if ((Event.InventoryId & 0xFFFF0000) != TestInventoryId)
+                continue;
+
+            ++NumCheckedEvents;
+
+            const bool bIsWhole = int32(Event.InventoryId & 0xFFFF) == Event.SlotIndex / EventsPerProducer
+                && Event.OtherSlotIndex == ~Event.SlotIndex
+                && Event.ItemId == (Event.SlotIndex ^ 0x5A5A5A5A)
+                && Event.Type == EInventoryTraceEventType::Swapped
+                && Event.DragState == uint8(Event.SlotIndex);
+
+            if (!bIsWhole)
+                ++NumTornEvents;
+        }
+    }
+
+    AddInfo(FString::Printf(TEXT("%d snapshots checked %d events"), NumSnapshots, NumCheckedEvents));
+    TestTrue(TEXT("Snapshots saw events"), NumCheckedEvents > 0);
+    TestEqual(TEXT("Torn events"), NumTornEvents, 0);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include "InventoryTestHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Transfers between inventories with different stack limits: what doesn't fit stays behind, swaps that can't fit
+// are refused, and a transfer that moves nothing leaves the destination's archetype table alone
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryTransferStackLimitTest, "Inventory.Transfers.StackLimits", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInventoryTransferStackLimitTest::RunTest(const FString& Parameters)
+{
+    FInventoryTestFixture Fixture;
+    if (!Fixture.IsValidFor(*this))
+        return false;
+
+    UInventory& Inventory = Fixture.GetInventory();
+    Fixture.SetGridSize(3, 4);
+
+    UInventory& Pouch = Fixture.AddOtherInventory(1, 2);
+    FInventoryTestAccess::SetMaxStackSize(Pouch, 5);
+
+    // A stack of 12 cubes and a single sphere in the inventory
+    for (int32 PickupIndex = 0; PickupIndex < 12; ++PickupIndex)
+        Inventory.AddItem(Fixture.SpawnItemActor(0));
+    Inventory.AddItem(Fixture.SpawnItemActor(1));
+
+    TestEqual(TEXT("Cube stack"), Inventory.GetItemQuantity(0), 12);
+
+    // Into an empty slot only a pouch sized stack moves, the rest stays in the source slot
+    TestEqual(TEXT("Partial transfer written"), UInventory::TransferItem(&Inventory, 0, &Pouch, 0), 0);
+    TestEqual(TEXT("Pouch stack capped"), Pouch.GetItemQuantity(0), 5);
+    TestEqual(TEXT("Remainder stays behind"), Inventory.GetItemQuantity(0), 7);
+
+    // The sphere fits the pouch's other slot
+    TestEqual(TEXT("Sphere transferred"), UInventory::TransferItem(&Inventory, 1, &Pouch, 1), 1);
+
+    // Swapping 7 cubes for the sphere would overfill the pouch slot
+    TestEqual(TEXT("Oversized swap refused"), UInventory::TransferItem(&Inventory, 0, &Pouch, 1), INDEX_NONE);
+    TestEqual(TEXT("Source keeps its stack"), Inventory.GetItemQuantity(0), 7);
+    TestEqual(TEXT("Pouch keeps the sphere"), Pouch.GetItemQuantity(1), 1);
+
+    // The pouch is full: a cylinder moves nowhere and must not end up in its archetype table
+    Inventory.AddItem(Fixture.SpawnItemActor(2));
+    const TArray<int32> CylinderSlots = Inventory.FindSlotsByMesh(TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cylinder.Cylinder"))));
+    if (!TestEqual(TEXT("One cylinder stack"), CylinderSlots.Num(), 1))
+        return false;
+
+    const int32 PouchArchetypes = FInventoryTestAccess::GetNumArchetypes(Pouch);
+    TestEqual(TEXT("Nothing fits a full pouch"), UInventory::TransferItem(&Inventory, CylinderSlots[0], &Pouch, INDEX_NONE), INDEX_NONE);
+    TestEqual(TEXT("Refused transfer imports no archetype"), FInventoryTestAccess::GetNumArchetypes(Pouch), PouchArchetypes);
+
+    // Topping up a full stack of the same item moves nothing either
+    TestEqual(TEXT("Full stack takes nothing"), UInventory::TransferItem(&Inventory, 0, &Pouch, 0), INDEX_NONE);
+    TestEqual(TEXT("Source unchanged by the full stack"), Inventory.GetItemQuantity(0), 7);
+
+    return true;
+}
+
+#endif
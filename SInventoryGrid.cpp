@@ -0,0 +1,148 @@
+#include "SInventoryGrid.h"
+#include "InventoryStats.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Fonts/FontMeasure.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+void SInventoryGrid::Construct(const FArguments& InArgs)
+{
+    SlotSize = InArgs._SlotSize;
+    SlotPadding = InArgs._SlotPadding;
+    LabelFont = FCoreStyle::GetDefaultFontStyle("Regular", 20);
+
+    SetGridSize(InArgs._NumColumns, InArgs._NumRows);
+}
+
+void SInventoryGrid::SetGridSize(int32 InNumColumns, int32 InNumRows)
+{
+    NumColumns = FMath::Max(InNumColumns, 0);
+    NumRows = FMath::Max(InNumRows, 0);
+
+    SlotVisuals.Reset();
+    SlotVisuals.SetNum(NumColumns * NumRows);
+
+    Invalidate(EInvalidateWidgetReason::Layout);
+}
+
+void SInventoryGrid::SetSlot(int32 SlotIndex, bool bShowsItem, const FText& Label)
+{
+    if (!SlotVisuals.IsValidIndex(SlotIndex))
+        return;
+
+    FInventoryGridSlotVisual& SlotVisual = SlotVisuals[SlotIndex];
+    if (SlotVisual.bShowsItem == bShowsItem && SlotVisual.Label.IdenticalTo(Label))
+        return;
+
+    if (!SlotVisual.Label.IdenticalTo(Label))
+    {
+        SlotVisual.Label = Label;
+        SlotVisual.LabelSize = FSlateApplication::IsInitialized()
+            ? FVector2D(FSlateApplication::Get().GetRenderer()->GetFontMeasureService()->Measure(Label, LabelFont))
+            : FVector2D::ZeroVector;
+    }
+
+    SlotVisual.bShowsItem = bShowsItem;
+
+    // Slot sizes never change here, so repainting is enough
+    Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+const TArray<FInventoryGridSlotVisual>& SInventoryGrid::GetSlots() const
+{
+    return SlotVisuals;
+}
+
+int32 SInventoryGrid::GetSlotAt(const FVector2D& AbsolutePosition) const
+{
+    const float SlotPitch = GetSlotPitch();
+    if (SlotPitch <= 0.0f)
+        return INDEX_NONE;
+
+    const FVector2D LocalPosition = GetCachedGeometry().AbsoluteToLocal(AbsolutePosition);
+    if (LocalPosition.X < 0.0f || LocalPosition.Y < 0.0f)
+        return INDEX_NONE;
+
+    const int32 Column = FMath::FloorToInt32(LocalPosition.X / SlotPitch);
+    const int32 Row = FMath::FloorToInt32(LocalPosition.Y / SlotPitch);
+    if (Column >= NumColumns || Row >= NumRows)
+        return INDEX_NONE;
+
+    // Position inside the cell, the padding around the slot doesn't count
+    const FVector2D CellPosition = LocalPosition - FVector2D(Column * SlotPitch + SlotPadding, Row * SlotPitch + SlotPadding);
+    if (CellPosition.X < 0.0f || CellPosition.Y < 0.0f || CellPosition.X > SlotSize || CellPosition.Y > SlotSize)
+        return INDEX_NONE;
+
+    return Row * NumColumns + Column;
+}
+
+int32 SInventoryGrid::GetLastPaintDrawElementCount() const
+{
+    return LastPaintDrawElementCount;
+}
+
+int32 SInventoryGrid::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+    INVENTORY_SCOPE_CYCLE_COUNTER(STAT_InventoryGridPaint);
+
+    // Backgrounds, icons and labels each get their own layer, every element of a layer shares brush or font
+    // so Slate batches each layer into a single draw
+    const int32 BackgroundLayer = LayerId;
+    const int32 IconLayer = LayerId + 1;
+    const int32 LabelLayer = LayerId + 2;
+
+    const FLinearColor Tint = InWidgetStyle.GetColorAndOpacityTint();
+    const FLinearColor LabelColor = FLinearColor::Red * Tint;
+    const FVector2D SlotExtent(SlotSize, SlotSize);
+
+    int32 DrawElementCount = 0;
+
+    for (int32 SlotIndex = 0; SlotIndex < SlotVisuals.Num(); ++SlotIndex)
+    {
+        const FVector2D SlotPosition = GetSlotPosition(SlotIndex);
+
+        // Rows scrolled out of the viewport are clipped anyway, they're not worth a draw element
+        const FSlateRect SlotRect(AllottedGeometry.LocalToAbsolute(SlotPosition), AllottedGeometry.LocalToAbsolute(SlotPosition + SlotExtent));
+        if (!FSlateRect::DoRectanglesIntersect(SlotRect, MyCullingRect))
+            continue;
+
+        const FPaintGeometry SlotGeometry = AllottedGeometry.ToPaintGeometry(SlotExtent, FSlateLayoutTransform(SlotPosition));
+        FSlateDrawElement::MakeBox(OutDrawElements, BackgroundLayer, SlotGeometry, &SlotBrush, ESlateDrawEffect::None, SlotBrush.TintColor.GetSpecifiedColor() * Tint);
+        ++DrawElementCount;
+
+        const FInventoryGridSlotVisual& SlotVisual = SlotVisuals[SlotIndex];
+        if (!SlotVisual.bShowsItem)
+            continue;
+
+        FSlateDrawElement::MakeBox(OutDrawElements, IconLayer, SlotGeometry, &IconBrush, ESlateDrawEffect::None, IconBrush.TintColor.GetSpecifiedColor() * Tint);
+        ++DrawElementCount;
+
+        if (SlotVisual.Label.IsEmpty())
+            continue;
+
+        const FVector2D LabelPosition = SlotPosition + (SlotExtent - SlotVisual.LabelSize) * 0.5f;
+        FSlateDrawElement::MakeText(OutDrawElements, LabelLayer, AllottedGeometry.ToPaintGeometry(SlotVisual.LabelSize, FSlateLayoutTransform(LabelPosition)), SlotVisual.Label, LabelFont, ESlateDrawEffect::None, LabelColor);
+        ++DrawElementCount;
+    }
+
+    LastPaintDrawElementCount = DrawElementCount;
+    INVENTORY_INC_COUNTER_BY(STAT_InventoryGridDrawElements, DrawElementCount);
+
+    return LabelLayer;
+}
+
+FVector2D SInventoryGrid::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+    return FVector2D(NumColumns * GetSlotPitch(), NumRows * GetSlotPitch());
+}
+
+FVector2D SInventoryGrid::GetSlotPosition(int32 SlotIndex) const
+{
+    const float SlotPitch = GetSlotPitch();
+    return FVector2D((SlotIndex % NumColumns) * SlotPitch + SlotPadding, (SlotIndex / NumColumns) * SlotPitch + SlotPadding);
+}
+
+float SInventoryGrid::GetSlotPitch() const
+{
+    return SlotSize + 2.0f * SlotPadding;
+}
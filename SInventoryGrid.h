@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+#include "Brushes/SlateColorBrush.h"
+#include "Fonts/SlateFontInfo.h"
+
+// What one slot of the leaf grid shows
+struct FInventoryGridSlotVisual
+{
+    FText Label;
+
+    // Label size measured once when the label is set, painting only centers it
+    FVector2D LabelSize = FVector2D::ZeroVector;
+
+    bool bShowsItem = false;
+};
+
+// Paints a whole inventory grid (slot backgrounds, item icons and labels) as a single leaf widget
+// Replaces a border, size box, overlay, image and text block per slot, and hit-tests slots with plain arithmetic
+class SInventoryGrid : public SLeafWidget
+{
+public:
+    SLATE_BEGIN_ARGS(SInventoryGrid)
+        : _NumColumns(4)
+        , _NumRows(3)
+        , _SlotSize(100.0f)
+        , _SlotPadding(7.0f)
+    {}
+        SLATE_ARGUMENT(int32, NumColumns)
+        SLATE_ARGUMENT(int32, NumRows)
+        SLATE_ARGUMENT(float, SlotSize)
+        SLATE_ARGUMENT(float, SlotPadding)
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs);
+
+    // Resizes the grid, every slot ends up empty
+    void SetGridSize(int32 InNumColumns, int32 InNumRows);
+
+    // Shows an item with a label on a slot or empties it, only invalidates paint (and only when something changed)
+    void SetSlot(int32 SlotIndex, bool bShowsItem, const FText& Label);
+
+    const TArray<FInventoryGridSlotVisual>& GetSlots() const;
+
+    // Returns the slot under an absolute position, INDEX_NONE over the padding or outside of the grid
+    int32 GetSlotAt(const FVector2D& AbsolutePosition) const;
+
+    // Number of draw elements the last paint emitted
+    int32 GetLastPaintDrawElementCount() const;
+
+    virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+protected:
+    virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+    // Top left corner of a slot relative to the grid
+    FVector2D GetSlotPosition(int32 SlotIndex) const;
+
+    float GetSlotPitch() const;
+
+    TArray<FInventoryGridSlotVisual> SlotVisuals;
+
+    int32 NumColumns = 0;
+
+    int32 NumRows = 0;
+
+    float SlotSize = 0.0f;
+
+    float SlotPadding = 0.0f;
+
+    // Every slot shares these, so each paint layer batches into one draw
+    FSlateColorBrush SlotBrush = FSlateColorBrush(FLinearColor(0.1f, 0.1f, 0.1f, 1.0f));
+
+    FSlateColorBrush IconBrush = FSlateColorBrush(FLinearColor::Blue);
+
+    FSlateFontInfo LabelFont;
+
+    mutable int32 LastPaintDrawElementCount = 0;
+};